@@ -0,0 +1,281 @@
+// Benchmark for the ex1 hull engines on inputs with small hulls
+// Usage: ./convex_hull_bench [n] [repeats]
+//        ./convex_hull_bench --parse [points]
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "convex_chan.hpp"
+#include "convex_hull.hpp"
+#include "convex_jarvis.hpp"
+#include "line_reader.hpp"
+#include "point.hpp"
+
+struct Dataset {
+    const char* name;
+    std::vector<Point> points;
+};
+
+// Uniform points in a square
+static std::vector<Point> makeUniform(int n, std::mt19937& rng) {
+    std::uniform_real_distribution<float> d(-1000.0f, 1000.0f);
+    std::vector<Point> pts;
+    pts.reserve(n);
+    for (int i = 0; i < n; ++i)
+        pts.emplace_back(d(rng), d(rng));
+    return pts;
+}
+
+// Gaussian blob, very few hull vertices
+static std::vector<Point> makeGaussian(int n, std::mt19937& rng) {
+    std::normal_distribution<float> d(0.0f, 100.0f);
+    std::vector<Point> pts;
+    pts.reserve(n);
+    for (int i = 0; i < n; ++i)
+        pts.emplace_back(d(rng), d(rng));
+    return pts;
+}
+
+// Uniform points in a triangle plus its corners, hull of exactly 3
+static std::vector<Point> makeTriangle(int n, std::mt19937& rng) {
+    std::uniform_real_distribution<float> d(0.0f, 1.0f);
+    std::vector<Point> pts;
+    pts.reserve(n);
+    pts.emplace_back(0.0f, 0.0f);
+    pts.emplace_back(1000.0f, 0.0f);
+    pts.emplace_back(0.0f, 1000.0f);
+    for (int i = 3; i < n; ++i) {
+        float u = d(rng), v = d(rng);
+        if (u + v > 1.0f) { u = 1.0f - u; v = 1.0f - v; }
+        pts.emplace_back(1000.0f * u * 0.999f + 0.1f, 1000.0f * v * 0.999f + 0.1f);
+    }
+    return pts;
+}
+
+// Regular h-gon plus uniform points strictly inside it, hull of exactly h
+static std::vector<Point> makePolygon(int n, int h, std::mt19937& rng) {
+    const double pi = 3.14159265358979323846;
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<Point> pts;
+    pts.reserve(n);
+    for (int k = 0; k < h; ++k)
+        pts.emplace_back(1000.0 * std::cos(2 * pi * k / h), 1000.0 * std::sin(2 * pi * k / h));
+    double inner = 990.0 * std::cos(pi / h);
+    for (int i = h; i < n; ++i) {
+        double r = inner * std::sqrt(unit(rng)), a = 2 * pi * unit(rng);
+        pts.emplace_back(r * std::cos(a), r * std::sin(a));
+    }
+    return pts;
+}
+
+static const char* scanLevelName(ConvexJarvis::ScanLevel level) {
+    switch (level) {
+        case ConvexJarvis::ScanLevel::AVX2: return "avx2";
+        case ConvexJarvis::ScanLevel::SSE42: return "sse4.2";
+        default: return "scalar";
+    }
+}
+
+// Best-of-repeats time of one engine run in milliseconds
+template <typename Run>
+static double timeRun(int repeats, Run run) {
+    double best = 0.0;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        if (r == 0 || ms < best)
+            best = ms;
+    }
+    return best;
+}
+
+// Input throughput of the apps on a generated file of n points in their
+// format: the interactive std::cin >> loop against the batch reader.
+// Each reader runs once, so the first one also warms the page cache for
+// the rest; the cin loop goes first to take that hit.
+static int runParseBenchmark(long n) {
+    char path[] = "/tmp/hull_parse_XXXXXX";
+    int fd = mkstemp(path);
+    std::FILE* file = fd >= 0 ? fdopen(fd, "w") : nullptr;
+    if (file == nullptr) {
+        perror("mkstemp");
+        return 1;
+    }
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<float> d(-10000.0f, 10000.0f);
+    fprintf(file, "%ld\n", n);
+    for (long i = 0; i < n; ++i) {
+        float x = d(rng), y = d(rng);
+        fprintf(file, "%.3f %.3f\n", x, y);
+    }
+    double mb = ftell(file) / 1e6;
+    std::fclose(file);
+    printf("%ld points, %.1f MB\n", n, mb);
+    printf("%-12s %10s %10s %10s %8s\n", "reader", "time (s)", "MB/s", "Mpts/s", "hull");
+
+    std::vector<Point> reference, points;
+    auto report = [&](const char* name, double ms, size_t hull) {
+        printf("%-12s %10.3f %10.1f %10.2f %8zu\n", name, ms / 1000.0, mb * 1000.0 / ms,
+               n / (ms * 1000.0), hull);
+    };
+
+    // The apps' loop, without the prompts
+    double ms = timeRun(1, [&]() {
+        if (std::freopen(path, "r", stdin) == nullptr) return;
+        long count = 0;
+        std::cin.clear();
+        std::cin >> count;
+        reference.clear();
+        for (long i = 0; i < count; ++i) {
+            float x, y;
+            std::cin >> x >> y;
+            reference.emplace_back(x, y);
+        }
+    });
+    report("cin >>", ms, 0);
+
+    ms = timeRun(1, [&]() {
+        std::FILE* in = std::fopen(path, "rb");
+        if (in == nullptr) return;
+        LineReader lines(in);
+        long count;
+        readCountedPoints(lines, count, points);
+        std::fclose(in);
+    });
+    report("batch", ms, 0);
+
+    // End to end, as convex_hull_app --batch runs it
+    size_t h = 0;
+    ms = timeRun(1, [&]() {
+        std::FILE* in = std::fopen(path, "rb");
+        if (in == nullptr) return;
+        LineReader lines(in);
+        long count;
+        readCountedPoints(lines, count, points);
+        std::fclose(in);
+        ConvexHull ch(points);
+        ch.findConvexHull();
+        h = ch.getConvexHullPoints().size();
+    });
+    report("batch+hull", ms, h);
+
+    unlink(path);
+    bool same = points.size() == reference.size();
+    for (size_t i = 0; same && i < points.size(); ++i)
+        same = points[i] == reference[i];
+    printf("batch points %s the cin >> points\n", same ? "match" : "DIFFER from");
+    return same ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--parse") == 0) {
+        long n = argc > 2 ? atol(argv[2]) : 10000000;
+        if (n < 3) {
+            fprintf(stderr, "Usage: %s --parse [points >= 3]\n", argv[0]);
+            return 1;
+        }
+        return runParseBenchmark(n);
+    }
+
+    int n = argc > 1 ? atoi(argv[1]) : 1000000;
+    int repeats = argc > 2 ? atoi(argv[2]) : 3;
+    if (n < 3 || repeats < 1) {
+        fprintf(stderr, "Usage: %s [n >= 3] [repeats >= 1]\n", argv[0]);
+        return 1;
+    }
+
+    std::mt19937 rng(12345);
+    std::vector<Dataset> datasets;
+    datasets.push_back({"uniform", makeUniform(n, rng)});
+    datasets.push_back({"gaussian", makeGaussian(n, rng)});
+    datasets.push_back({"triangle", makeTriangle(n, rng)});
+
+    printf("n = %d, best of %d runs\n", n, repeats);
+    printf("%-10s %-10s %12s %8s %10s\n", "dataset", "engine", "time (ms)", "hull", "discarded");
+    for (const auto& ds : datasets) {
+        size_t h = 0;
+        double ms = timeRun(repeats, [&]() {
+            ConvexHull ch(ds.points);
+            ch.findConvexHull();
+            h = ch.getConvexHullPoints().size();
+        });
+        printf("%-10s %-10s %12.2f %8zu\n", ds.name, "graham", ms, h);
+
+        ms = timeRun(repeats, [&]() {
+            ConvexJarvis cj(ds.points);
+            cj.findConvexJarvis();
+            h = cj.chPoints.size();
+        });
+        printf("%-10s %-10s %12.2f %8zu\n", ds.name, "jarvis", ms, h);
+
+        ms = timeRun(repeats, [&]() {
+            ConvexChan cc(ds.points);
+            cc.findConvexChan();
+            h = cc.chPoints.size();
+        });
+        printf("%-10s %-10s %12.2f %8zu\n", ds.name, "chan", ms, h);
+
+        size_t discarded = 0;
+        ms = timeRun(repeats, [&]() {
+            ConvexJarvis cj(ds.points);
+            cj.setPrefilter(true);
+            cj.findConvexJarvis();
+            h = cj.chPoints.size();
+            discarded = cj.getPrefilterDiscarded();
+        });
+        printf("%-10s %-10s %12.2f %8zu %10zu\n", ds.name, "pf+jarvis", ms, h, discarded);
+
+        ms = timeRun(repeats, [&]() {
+            ConvexChan cc(ds.points);
+            cc.setPrefilter(true);
+            cc.findConvexChan();
+            h = cc.chPoints.size();
+            discarded = cc.getPrefilterDiscarded();
+        });
+        printf("%-10s %-10s %12.2f %8zu %10zu\n", ds.name, "pf+chan", ms, h, discarded);
+    }
+
+    // Jarvis costs one scan of all n points per hull vertex, so medium
+    // hulls show the candidate scan's throughput
+    unsigned hw = std::thread::hardware_concurrency();
+    std::vector<unsigned> threadCounts = {1};
+    if (hw > 1)
+        threadCounts.push_back(hw);
+    const ConvexJarvis::ScanLevel levels[] = {ConvexJarvis::ScanLevel::Scalar,
+                                              ConvexJarvis::ScanLevel::SSE42,
+                                              ConvexJarvis::ScanLevel::AVX2};
+    ConvexJarvis::ScanLevel widest = ConvexJarvis::widestScanLevel();
+    printf("\nJarvis scan throughput (host supports %s)\n", scanLevelName(widest));
+    printf("%-10s %-8s %8s %12s %8s %12s %12s\n", "dataset", "level", "threads", "time (ms)", "hull",
+           "us/vertex", "Mpts/s");
+    for (int h : {64, 512}) {
+        std::vector<Point> pts = makePolygon(n, h, rng);
+        char name[32];
+        snprintf(name, sizeof(name), "%d-gon", h);
+        for (ConvexJarvis::ScanLevel level : levels) {
+            if (static_cast<int>(level) > static_cast<int>(widest))
+                continue;
+            for (unsigned threads : threadCounts) {
+                size_t hull = 0;
+                double ms = timeRun(repeats, [&]() {
+                    ConvexJarvis cj(pts);
+                    cj.setScanLevel(level);
+                    cj.setThreadCount(threads);
+                    cj.findConvexJarvis();
+                    hull = cj.chPoints.size();
+                });
+                printf("%-10s %-8s %8u %12.2f %8zu %12.2f %12.1f\n", name, scanLevelName(level), threads,
+                       ms, hull, ms * 1000.0 / hull, double(n) * hull / (ms * 1000.0));
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,191 @@
+#include "convex_chan.hpp"
+#include "predicates.hpp"
+#include "prefilter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+// Constructor
+ConvexChan::ConvexChan(std::vector<Point> graph) : graph(graph) {}
+
+// Orientation of 3 points
+int ConvexChan::orientation(const Point& a, const Point& b, const Point& c) const {
+    return orient2d(a, b, c); // +1 counterclockwise, -1 clockwise, 0 collinear
+}
+
+// Same choice ConvexJarvis makes when scanning for the next hull vertex
+bool ConvexChan::isBetterCandidate(const Point& p, const Point& a, const Point& b) const {
+    int orient = orientation(p, b, a);
+    if (orient != 0)
+        return orient == 1;
+    double adx = a.getX() - p.getX(), ady = a.getY() - p.getY();
+    double bdx = b.getX() - p.getX(), bdy = b.getY() - p.getY();
+    return bdx * bdx + bdy * bdy > adx * adx + ady * ady;
+}
+
+// Monotone chain on one group, counterclockwise with no collinear vertices
+void ConvexChan::appendSubHull(int first, int last) {
+    auto begin = graph.begin() + first;
+    auto end = graph.begin() + last;
+    std::sort(begin, end, [](const Point& a, const Point& b) {
+        if (a.getX() != b.getX())
+            return a.getX() < b.getX();
+        return a.getY() < b.getY();
+    });
+    end = std::unique(begin, end);
+
+    int n = end - begin;
+    int base = hullPoints.size();
+    hullOffsets.push_back(base);
+    if (n < 3) {
+        hullPoints.insert(hullPoints.end(), begin, end);
+        return;
+    }
+
+    hullPoints.resize(base + 2 * n);
+    Point* hull = hullPoints.data() + base;
+    int k = 0;
+    for (int i = 0; i < n; ++i) {
+        while (k >= 2 && orientation(hull[k - 2], hull[k - 1], begin[i]) <= 0)
+            --k;
+        hull[k++] = begin[i];
+    }
+    for (int i = n - 2, lower = k + 1; i >= 0; --i) {
+        while (k >= lower && orientation(hull[k - 2], hull[k - 1], begin[i]) <= 0)
+            --k;
+        hull[k++] = begin[i];
+    }
+    hullPoints.resize(base + k - 1);
+}
+
+// Binary search for the vertex q with the whole sub-hull left of p->q.
+// Degenerate inputs (p on the sub-hull, collinear edges) fall back to a
+// linear scan of this sub-hull, which keeps the result exact.
+int ConvexChan::tangent(const Point* hull, int n, const Point& p) const {
+    auto linearScan = [&]() {
+        int best = -1;
+        for (int i = 0; i < n; ++i) {
+            if (hull[i] == p) continue;
+            if (best < 0 || isBetterCandidate(p, hull[best], hull[i]))
+                best = i;
+        }
+        return best;
+    };
+    if (n <= 3) return linearScan();
+
+    int l = 0, r = n;
+    int lBefore = orientation(p, hull[0], hull[n - 1]);
+    int lAfter = orientation(p, hull[0], hull[1]);
+    int found = -1;
+    while (l < r) {
+        int c = (l + r) / 2;
+        int cBefore = orientation(p, hull[c], hull[(c - 1 + n) % n]);
+        int cAfter = orientation(p, hull[c], hull[(c + 1) % n]);
+        int cSide = orientation(p, hull[l], hull[c]);
+        if (cBefore != -1 && cAfter != -1) {
+            found = c;
+            break;
+        }
+        if ((cSide == 1 && (lAfter == -1 || lBefore == lAfter)) || (cSide == -1 && cBefore == -1))
+            r = c;
+        else
+            l = c + 1;
+        lBefore = -cAfter;
+        lAfter = orientation(p, hull[l % n], hull[(l + 1) % n]);
+    }
+    if (found < 0) found = l % n;
+
+    // Verify the candidate, preferring the farther of two collinear vertices
+    const Point& q = hull[found];
+    int prev = (found - 1 + n) % n, next = (found + 1) % n;
+    if (q == p || orientation(p, q, hull[prev]) == -1 || orientation(p, q, hull[next]) == -1)
+        return linearScan();
+    if (isBetterCandidate(p, q, hull[next])) return next;
+    if (isBetterCandidate(p, q, hull[prev])) return prev;
+    return found;
+}
+
+bool ConvexChan::wrapWithGroupSize(int m, const Point& start) {
+    int n = graph.size();
+    hullPoints.clear();
+    hullOffsets.clear();
+    for (int first = 0; first < n; first += m)
+        appendSubHull(first, std::min(first + m, n));
+    hullOffsets.push_back(hullPoints.size());
+    int groups = hullOffsets.size() - 1;
+
+    chPoints.clear();
+    Point current = start;
+    for (int step = 0; step < m; ++step) {
+        chPoints.push_back(current);
+
+        // Best tangent over all sub-hulls, using the Jarvis tie-breaking
+        bool found = false;
+        Point next = current;
+        for (int g = 0; g < groups; ++g) {
+            const Point* hull = hullPoints.data() + hullOffsets[g];
+            int t = tangent(hull, hullOffsets[g + 1] - hullOffsets[g], current);
+            if (t < 0) continue;
+            if (!found || isBetterCandidate(current, next, hull[t])) {
+                next = hull[t];
+                found = true;
+            }
+        }
+
+        if (!found || next == start)
+            return true;
+        current = next;
+    }
+    return false;
+}
+
+void ConvexChan::findConvexChan() {
+    chPoints.clear();
+
+    // graph is private and already reordered by the rounds, so interior
+    // points can be dropped from it in place
+    prefilterDiscarded = 0;
+    if (prefilter) {
+        std::vector<Point> filtered;
+        prefilterDiscarded = aklToussaintFilter(graph, filtered);
+        graph.swap(filtered);
+    }
+
+    int n = graph.size();
+
+    if (n < 3) return;
+
+    // Find the leftmost point
+    int leftmost = 0;
+    for (int i = 1; i < n; i++) {
+        if (graph[i].getX() < graph[leftmost].getX() ||
+            (graph[i].getX() == graph[leftmost].getX() && graph[i].getY() < graph[leftmost].getY())) {
+            leftmost = i;
+        }
+    }
+
+    // Guess h with m = 2^(2^t) until one wrap closes
+    Point start = graph[leftmost];
+    for (int t = 3;; ++t) {
+        long long m = t >= 5 ? n : std::min<long long>(1LL << (1 << t), n);
+        if (wrapWithGroupSize(static_cast<int>(m), start) || m == n)
+            return;
+    }
+}
+
+// Calculate area of the convex hull polygon
+double ConvexChan::polygonArea() const {
+    double area = 0.0;
+    int n = chPoints.size();
+
+    if (n < 3) return 0.0;
+
+    // Using shoelace formula
+    for (int i = 0; i < n; ++i) {
+        const Point& p1 = chPoints[i];
+        const Point& p2 = chPoints[(i + 1) % n];
+        area += (p1.getX() * p2.getY()) - (p2.getX() * p1.getY());
+    }
+
+    return std::abs(area) / 2.0;
+}
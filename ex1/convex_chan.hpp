@@ -0,0 +1,48 @@
+#pragma once
+
+#include "point.hpp"
+#include <cstddef>
+#include <vector>
+
+class ConvexChan {
+public:
+    // Constructor
+    ConvexChan(std::vector<Point> graph);
+
+    // Chan's algorithm, O(n log h): same output as ConvexJarvis::findConvexJarvis
+    void findConvexChan();
+
+    // Calculate area of the convex hull polygon
+    double polygonArea() const;
+
+    // Akl-Toussaint prefilter before the rounds; the count is from the last run
+    void setPrefilter(bool enabled) { prefilter = enabled; }
+    size_t getPrefilterDiscarded() const { return prefilterDiscarded; }
+
+    // Points of the convex hull
+    std::vector<Point> chPoints;
+
+private:
+    std::vector<Point> graph;
+    bool prefilter = false;
+    size_t prefilterDiscarded = 0;
+
+    // Orientation of 3 points
+    int orientation(const Point& a, const Point& b, const Point& c) const;
+
+    // True if b wraps further clockwise than a as seen from p (Jarvis rule)
+    bool isBetterCandidate(const Point& p, const Point& a, const Point& b) const;
+
+    // Sub-hulls of the current round, stored back to back
+    std::vector<Point> hullPoints;
+    std::vector<int> hullOffsets;
+
+    // Appends the counterclockwise hull of graph[first, last) to hullPoints
+    void appendSubHull(int first, int last);
+
+    // Index of the tangent from p to a counterclockwise sub-hull
+    int tangent(const Point* hull, int n, const Point& p) const;
+
+    // One Chan round with sub-hulls of size m; false if h > m
+    bool wrapWithGroupSize(int m, const Point& start);
+};
@@ -1,4 +1,5 @@
 #include "convex_hull.hpp"
+#include "predicates.hpp"
 #include <algorithm>
 #include <cmath>
 
@@ -7,12 +8,7 @@ ConvexHull::ConvexHull(std::vector<Point> graph) : graph(graph) {}
 
 // Orientation of 3 points
 int ConvexHull::orientation(Point a, Point b, Point c) {
-    double v = a.getX() * (b.getY() - c.getY()) +
-               b.getX() * (c.getY() - a.getY()) +
-               c.getX() * (a.getY() - b.getY());
-    if (v < 0) return -1;
-    if (v > 0) return +1;
-    return 0;
+    return orient2d(a, b, c); // +1 counterclockwise, -1 clockwise, 0 collinear
 }
 
 
@@ -1,25 +1,311 @@
 #include "convex_jarvis.hpp"
+#include "predicates.hpp"
+#include "prefilter.hpp"
 #include <algorithm>
 #include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define JARVIS_SIMD_X86 1
+#endif
 
 // Constructor
-ConvexJarvis::ConvexJarvis(std::vector<Point> graph) : graph(graph) {}
+ConvexJarvis::ConvexJarvis(std::vector<Point> graph) : graph(graph), scanLevel(widestScanLevel()) {}
+
+ConvexJarvis::ScanLevel ConvexJarvis::widestScanLevel() {
+#ifdef JARVIS_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return ScanLevel::AVX2;
+    if (__builtin_cpu_supports("sse4.2"))
+        return ScanLevel::SSE42;
+#endif
+    return ScanLevel::Scalar;
+}
+
+void ConvexJarvis::setScanLevel(ScanLevel level) {
+    ScanLevel widest = widestScanLevel();
+    scanLevel = static_cast<int>(level) > static_cast<int>(widest) ? widest : level;
+}
 
 // Orientation of 3 points
 int ConvexJarvis::orientation(Point a, Point b, Point c) {
-    double v = a.getX() * (b.getY() - c.getY()) +
-               b.getX() * (c.getY() - a.getY()) +
-               c.getX() * (a.getY() - b.getY());
-    if (v < 0) return -1; // Clockwise
-    if (v > 0) return +1; // Counterclockwise
-    return 0; // Collinear
+    return orient2d(a, b, c); // +1 counterclockwise, -1 clockwise, 0 collinear
+}
+
+//------------------- Candidate scan ------------------------------------
+
+// Point::distanceTo in the same float operations
+static inline float distanceFrom(float ax, float ay, float x, float y) {
+    float dx = x - ax;
+    float dy = y - ay;
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+// True if point i should replace next as the candidate seen from current:
+// next lies counterclockwise of current->i, or the three are collinear and
+// i is farther
+static inline bool beats(const float* xs, const float* ys, int current, int i, int next) {
+    int orient = orient2d(xs[current], ys[current], xs[i], ys[i], xs[next], ys[next]);
+    if (orient != 0)
+        return orient == 1;
+    return distanceFrom(xs[current], ys[current], xs[i], ys[i]) >
+           distanceFrom(xs[current], ys[current], xs[next], ys[next]);
+}
+
+// The march's inner loop over [begin, end), starting from candidate next
+static int scanScalar(const float* xs, const float* ys, int begin, int end, int current, int next) {
+    for (int i = begin; i < end; i++) {
+        if (beats(xs, ys, current, i, next))
+            next = i;
+    }
+    return next;
+}
+
+// The vector scans keep one candidate per lane, each the first of the
+// best points of its lane, and then offer those to next in index order.
+// Replacement is a strict weak order whenever the scan starts at a hull
+// vertex, so this picks the same point as scanScalar: next if nothing
+// beats it, else the first of the best.
+static int foldLanes(const float* xs, const float* ys, int current, int next, int* lanes, int count) {
+    std::sort(lanes, lanes + count);
+    for (int k = 0; k < count; ++k) {
+        if (beats(xs, ys, current, lanes[k], next))
+            next = lanes[k];
+    }
+    return next;
+}
+
+#ifdef JARVIS_SIMD_X86
+
+// distanceFrom() on four lanes
+__attribute__((target("sse4.2")))
+static inline __m128 distanceFrom(__m128 ax, __m128 ay, __m128 x, __m128 y) {
+    __m128 dx = _mm_sub_ps(x, ax), dy = _mm_sub_ps(y, ay);
+    return _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+}
+
+__attribute__((target("sse4.2")))
+static inline __m128 loadPair(const float* p) {
+    return _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+}
+
+// orient2d's filter on two lanes: the error bound and the zero side tests
+// are the same, and lanes it cannot settle go to orient2dExact()
+__attribute__((target("sse4.2")))
+static int scanSse42(const float* xs, const float* ys, int begin, int end, int current, int next) {
+    if (end - begin < 4)
+        return scanScalar(xs, ys, begin, end, current, next);
+
+    const float ax = xs[current], ay = ys[current];
+    const __m128d axd = _mm_set1_pd(ax), ayd = _mm_set1_pd(ay);
+    const __m128 axf = _mm_set1_ps(ax), ayf = _mm_set1_ps(ay);
+    const __m128d bound = _mm_set1_pd(orientErrBound), zero = _mm_setzero_pd();
+    const __m128d absMask = _mm_castsi128_pd(_mm_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+
+    __m128 xf = loadPair(xs + begin), yf = loadPair(ys + begin);
+    __m128d bx = _mm_cvtps_pd(xf), by = _mm_cvtps_pd(yf), bd = _mm_cvtps_pd(distanceFrom(axf, ayf, xf, yf));
+    __m128d bi = _mm_set_pd(begin + 1, begin);
+    int i = begin + 2;
+    for (; i + 2 <= end; i += 2) {
+        xf = loadPair(xs + i);
+        yf = loadPair(ys + i);
+        __m128d x = _mm_cvtps_pd(xf), y = _mm_cvtps_pd(yf);
+
+        // orient2d(current, i, lane candidate)
+        __m128d left = _mm_mul_pd(_mm_sub_pd(axd, bx), _mm_sub_pd(y, by));
+        __m128d right = _mm_mul_pd(_mm_sub_pd(ayd, by), _mm_sub_pd(x, bx));
+        __m128d det = _mm_sub_pd(left, right);
+        __m128d err = _mm_mul_pd(bound, _mm_add_pd(_mm_and_pd(left, absMask), _mm_and_pd(right, absMask)));
+        __m128d sure = _mm_or_pd(_mm_cmpgt_pd(_mm_and_pd(det, absMask), err),
+                                 _mm_or_pd(_mm_cmpeq_pd(left, zero), _mm_cmpeq_pd(right, zero)));
+        __m128d ccw = _mm_cmpgt_pd(det, zero), flat = _mm_cmpeq_pd(det, zero);
+        int unsure = ~_mm_movemask_pd(sure) & 0x3;
+        if (unsure) {
+            alignas(16) double cx[2], cy[2], o[2], z[2];
+            _mm_store_pd(cx, bx);
+            _mm_store_pd(cy, by);
+            _mm_store_pd(o, ccw);
+            _mm_store_pd(z, flat);
+            for (int k = 0; k < 2; ++k) {
+                if (!(unsure >> k & 1)) continue;
+                int s = orient2dExact(ax, ay, xs[i + k], ys[i + k], float(cx[k]), float(cy[k]));
+                o[k] = s > 0 ? -1.0 : 0.0;
+                z[k] = s == 0 ? -1.0 : 0.0;
+            }
+            ccw = _mm_cmpneq_pd(_mm_load_pd(o), zero);
+            flat = _mm_cmpneq_pd(_mm_load_pd(z), zero);
+        }
+
+        __m128d d = _mm_cvtps_pd(distanceFrom(axf, ayf, xf, yf));
+        __m128d take = _mm_or_pd(ccw, _mm_and_pd(flat, _mm_cmpgt_pd(d, bd)));
+        bx = _mm_blendv_pd(bx, x, take);
+        by = _mm_blendv_pd(by, y, take);
+        bd = _mm_blendv_pd(bd, d, take);
+        bi = _mm_blendv_pd(bi, _mm_set_pd(i + 1, i), take);
+    }
+
+    alignas(16) double idx[2];
+    _mm_store_pd(idx, bi);
+    int lanes[2] = {int(idx[0]), int(idx[1])};
+    next = foldLanes(xs, ys, current, next, lanes, 2);
+    return scanScalar(xs, ys, i, end, current, next);
+}
+
+__attribute__((target("avx2")))
+static int scanAvx2(const float* xs, const float* ys, int begin, int end, int current, int next) {
+    if (end - begin < 8)
+        return scanScalar(xs, ys, begin, end, current, next);
+
+    const float ax = xs[current], ay = ys[current];
+    const __m256d axd = _mm256_set1_pd(ax), ayd = _mm256_set1_pd(ay);
+    const __m128 axf = _mm_set1_ps(ax), ayf = _mm_set1_ps(ay);
+    const __m256d bound = _mm256_set1_pd(orientErrBound), zero = _mm256_setzero_pd();
+    const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+
+    __m128 xf = _mm_loadu_ps(xs + begin), yf = _mm_loadu_ps(ys + begin);
+    __m256d bx = _mm256_cvtps_pd(xf), by = _mm256_cvtps_pd(yf), bd = _mm256_cvtps_pd(distanceFrom(axf, ayf, xf, yf));
+    const __m256d step = _mm256_set_pd(3, 2, 1, 0);
+    __m256d bi = _mm256_add_pd(_mm256_set1_pd(begin), step);
+    int i = begin + 4;
+    for (; i + 4 <= end; i += 4) {
+        xf = _mm_loadu_ps(xs + i);
+        yf = _mm_loadu_ps(ys + i);
+        __m256d x = _mm256_cvtps_pd(xf), y = _mm256_cvtps_pd(yf);
+
+        // orient2d(current, i, lane candidate)
+        __m256d left = _mm256_mul_pd(_mm256_sub_pd(axd, bx), _mm256_sub_pd(y, by));
+        __m256d right = _mm256_mul_pd(_mm256_sub_pd(ayd, by), _mm256_sub_pd(x, bx));
+        __m256d det = _mm256_sub_pd(left, right);
+        __m256d err = _mm256_mul_pd(bound, _mm256_add_pd(_mm256_and_pd(left, absMask),
+                                                         _mm256_and_pd(right, absMask)));
+        __m256d sure = _mm256_or_pd(_mm256_cmp_pd(_mm256_and_pd(det, absMask), err, _CMP_GT_OQ),
+                                    _mm256_or_pd(_mm256_cmp_pd(left, zero, _CMP_EQ_OQ),
+                                                 _mm256_cmp_pd(right, zero, _CMP_EQ_OQ)));
+        __m256d ccw = _mm256_cmp_pd(det, zero, _CMP_GT_OQ), flat = _mm256_cmp_pd(det, zero, _CMP_EQ_OQ);
+        int unsure = ~_mm256_movemask_pd(sure) & 0xF;
+        if (unsure) {
+            alignas(32) double cx[4], cy[4], o[4], z[4];
+            _mm256_store_pd(cx, bx);
+            _mm256_store_pd(cy, by);
+            _mm256_store_pd(o, ccw);
+            _mm256_store_pd(z, flat);
+            for (int k = 0; k < 4; ++k) {
+                if (!(unsure >> k & 1)) continue;
+                int s = orient2dExact(ax, ay, xs[i + k], ys[i + k], float(cx[k]), float(cy[k]));
+                o[k] = s > 0 ? -1.0 : 0.0;
+                z[k] = s == 0 ? -1.0 : 0.0;
+            }
+            ccw = _mm256_cmp_pd(_mm256_load_pd(o), zero, _CMP_NEQ_UQ);
+            flat = _mm256_cmp_pd(_mm256_load_pd(z), zero, _CMP_NEQ_UQ);
+        }
+
+        __m256d d = _mm256_cvtps_pd(distanceFrom(axf, ayf, xf, yf));
+        __m256d take = _mm256_or_pd(ccw, _mm256_and_pd(flat, _mm256_cmp_pd(d, bd, _CMP_GT_OQ)));
+        bx = _mm256_blendv_pd(bx, x, take);
+        by = _mm256_blendv_pd(by, y, take);
+        bd = _mm256_blendv_pd(bd, d, take);
+        bi = _mm256_blendv_pd(bi, _mm256_add_pd(_mm256_set1_pd(i), step), take);
+    }
+
+    alignas(32) double idx[4];
+    _mm256_store_pd(idx, bi);
+    int lanes[4] = {int(idx[0]), int(idx[1]), int(idx[2]), int(idx[3])};
+    next = foldLanes(xs, ys, current, next, lanes, 4);
+    return scanScalar(xs, ys, i, end, current, next);
+}
+
+#endif // JARVIS_SIMD_X86
+
+static int scanSlice(ConvexJarvis::ScanLevel level, const float* xs, const float* ys,
+                     int begin, int end, int current, int next) {
+    switch (level) {
+#ifdef JARVIS_SIMD_X86
+        case ConvexJarvis::ScanLevel::AVX2: return scanAvx2(xs, ys, begin, end, current, next);
+        case ConvexJarvis::ScanLevel::SSE42: return scanSse42(xs, ys, begin, end, current, next);
+#endif
+        default: return scanScalar(xs, ys, begin, end, current, next);
+    }
 }
 
+// Threads kept for a whole march, each scanning its slice of the points
+// once per hull vertex; the caller scans slice 0 itself
+class ScanCrew {
+public:
+    ScanCrew(unsigned threads, std::function<void(unsigned)> scan) : scan(scan) {
+        for (unsigned k = 1; k < threads; ++k)
+            workers.emplace_back([this, k]() { work(k); });
+    }
+
+    ~ScanCrew() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        start.notify_all();
+        for (auto& w : workers)
+            w.join();
+    }
+
+    // Scans every slice and waits for them
+    void run() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++round;
+            pending = workers.size();
+        }
+        start.notify_all();
+        scan(0);
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this]() { return pending == 0; });
+    }
+
+private:
+    std::function<void(unsigned)> scan;
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable start, done;
+    uint64_t round = 0;
+    size_t pending = 0;
+    bool stopping = false;
+
+    void work(unsigned slice) {
+        uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                start.wait(lock, [&]() { return stopping || round != seen; });
+                if (stopping) return;
+                seen = round;
+            }
+            scan(slice);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pending == 0)
+                done.notify_one();
+        }
+    }
+};
+
+//------------------- March ---------------------------------------------
+
 // Jarvis March (Gift Wrapping) algorithm
 void ConvexJarvis::findConvexJarvis() {
-    int n = graph.size();
     chPoints.clear();
-    
+
+    // March over the filtered copy so graph itself is left intact
+    std::vector<Point> filtered;
+    prefilterDiscarded = 0;
+    if (prefilter)
+        prefilterDiscarded = aklToussaintFilter(graph, filtered);
+    const std::vector<Point>& graph = prefilter ? filtered : this->graph;
+
+    int n = graph.size();
     if (n < 3) return;
     
     // Find the leftmost point
@@ -31,35 +317,50 @@ void ConvexJarvis::findConvexJarvis() {
         }
     }
     
-    // Start from leftmost point, keep moving counterclockwise
+    // SoA copy for the candidate scan
+    std::vector<float> xs(n), ys(n);
+    for (int i = 0; i < n; i++) {
+        xs[i] = graph[i].getX();
+        ys[i] = graph[i].getY();
+    }
+
+    // Slice k of the scan covers [n k / t, n (k + 1) / t)
+    unsigned threads = threadCount != 0 ? threadCount : std::thread::hardware_concurrency();
+    if (threads == 0 || static_cast<size_t>(n) < parallelCutoff)
+        threads = 1;
+    std::vector<int> best(threads);
     int current = leftmost;
+    auto scan = [&](unsigned k) {
+        int begin = static_cast<int>(int64_t(n) * k / threads);
+        int end = static_cast<int>(int64_t(n) * (k + 1) / threads);
+        int first = k == 0 ? (current + 1) % n : begin;
+        best[k] = scanSlice(scanLevel, xs.data(), ys.data(), begin, end, current, first);
+    };
+    std::unique_ptr<ScanCrew> crew;
+    if (threads > 1)
+        crew.reset(new ScanCrew(threads, scan));
+
+    // Start from leftmost point, keep moving counterclockwise
     do {
         // Add current point to result
         chPoints.push_back(graph[current]);
-        
-        // Find the most counterclockwise point from graph[current]
-        int next = (current + 1) % n;
-        
-        for (int i = 0; i < n; i++) {
-            // If i is more counterclockwise than current 'next', then update next
-            int orient = orientation(graph[current], graph[i], graph[next]);
-            
-            if (orient == 1) {
-                // i is more counterclockwise than next
-                next = i;
-            }
-            else if (orient == 0) {
-                // graph[current], graph[i] and graph[next] are collinear
-                // Choose the farthest point
-                if (graph[current].distanceTo(graph[i]) > graph[current].distanceTo(graph[next])) {
-                    next = i;
-                }
-            }
+
+        // Find the most counterclockwise point from graph[current]. Slice 0
+        // starts from graph[current + 1]; the later slices' picks are
+        // offered in index order, which keeps the sequential scan's choice.
+        if (crew)
+            crew->run();
+        else
+            scan(0);
+        int next = best[0];
+        for (unsigned k = 1; k < threads; k++) {
+            if (beats(xs.data(), ys.data(), current, best[k], next))
+                next = best[k];
         }
-        
+
         current = next;
         
-    } while (current != leftmost); // Keep going until we come back to start
+    } while (graph[current] != graph[leftmost]); // Keep going until we come back to start (or a copy of it)
 }
 
 // Calculate area of the convex hull polygon
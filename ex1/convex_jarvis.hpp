@@ -1,6 +1,7 @@
 #pragma once
 
 #include "point.hpp"
+#include <cstddef>
 #include <vector>
 
 class ConvexJarvis {
@@ -14,11 +15,32 @@ public:
     // Calculate area of the convex hull polygon
     double polygonArea() const;
 
+    // Akl-Toussaint prefilter before the march; the count is from the last run
+    void setPrefilter(bool enabled) { prefilter = enabled; }
+    size_t getPrefilterDiscarded() const { return prefilterDiscarded; }
+
+    // Instruction set of the candidate scan. The default is the widest the
+    // CPU supports; wider requests are clamped to it.
+    enum class ScanLevel { Scalar, SSE42, AVX2 };
+    static ScanLevel widestScanLevel();
+    void setScanLevel(ScanLevel level);
+    ScanLevel getScanLevel() const { return scanLevel; }
+
+    // Threads splitting the candidate scan (0 = one per hardware thread);
+    // inputs below the cutoff are scanned on the calling thread
+    void setThreadCount(unsigned threads) { threadCount = threads; }
+    void setParallelCutoff(size_t cutoff) { parallelCutoff = cutoff; }
+
     // Points of the convex hull
     std::vector<Point> chPoints;
 
 private:
     std::vector<Point> graph;
+    bool prefilter = false;
+    size_t prefilterDiscarded = 0;
+    ScanLevel scanLevel;
+    unsigned threadCount = 0;
+    size_t parallelCutoff = 1 << 16;
 
     // Orientation of 3 points
     int orientation(Point a, Point b, Point c);
@@ -0,0 +1,74 @@
+#include "line_reader.hpp"
+#include <algorithm>
+#include <cstring>
+
+LineReader::LineReader(std::FILE* in, size_t blockBytes) : in(in) {
+    block.resize(blockBytes > 0 ? blockBytes : 1);
+}
+
+// Moves the unparsed tail to the front and reads behind it; the block
+// doubles when a single line fills it
+bool LineReader::refill() {
+    if (eof) return false;
+    size_t tail = end - pos;
+    memmove(block.data(), block.data() + pos, tail);
+    pos = 0;
+    end = tail;
+    if (end == block.size())
+        block.resize(2 * block.size());
+    size_t got = std::fread(block.data() + end, 1, block.size() - end, in);
+    if (got == 0) {
+        eof = true;
+        error = std::ferror(in) != 0;
+    }
+    end += got;
+    bytes += got;
+    return got > 0;
+}
+
+bool LineReader::next(const char*& begin, const char*& lineEnd) {
+    for (;;) {
+        char* newline = static_cast<char*>(memchr(block.data() + pos, '\n', end - pos));
+        if (newline == nullptr && refill())
+            continue;
+        if (newline == nullptr && pos == end)
+            return false;
+
+        begin = block.data() + pos;
+        lineEnd = newline != nullptr ? newline : block.data() + end;
+        pos = newline != nullptr ? size_t(newline - block.data()) + 1 : end;
+        return true;
+    }
+}
+
+bool readCountedPoints(LineReader& lines, long& count, std::vector<Point>& points) {
+    count = 0;
+    points.clear();
+    bool haveCount = false, haveX = false;
+    float x = 0.0f;
+    const char* p;
+    const char* end;
+    while (lines.next(p, end)) {
+        for (;;) {
+            while (p != end && isBlank(*p)) ++p;
+            if (p == end) break;
+            if (!haveCount) {
+                if (!scanLong(p, end, count)) return false;
+                haveCount = true;
+                if (count < 3) return false;
+                // The count is untrusted input; past the cap the vector grows
+                points.reserve(size_t(std::min<long>(count, 1 << 20)));
+            } else if (!haveX) {
+                if (!scanFloat(p, end, x)) return false;
+                haveX = true;
+            } else {
+                float y;
+                if (!scanFloat(p, end, y)) return false;
+                points.emplace_back(x, y);
+                haveX = false;
+                if (points.size() == size_t(count)) return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,75 @@
+#ifndef LINE_READER_HPP
+#define LINE_READER_HPP
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "point.hpp"
+
+// Lines of a file, read in large blocks instead of through iostream
+class LineReader {
+public:
+    explicit LineReader(std::FILE* in, size_t blockBytes = 1 << 20);
+
+    // Next line as [begin, end), without its '\n', valid until the next
+    // call; false once the input is exhausted. A line longer than the
+    // block grows the block.
+    bool next(const char*& begin, const char*& end);
+
+    uint64_t bytesRead() const { return bytes; }
+    bool failed() const { return error; }
+
+private:
+    std::FILE* in;
+    std::vector<char> block;
+    size_t pos = 0;
+    size_t end = 0;
+    uint64_t bytes = 0;
+    bool eof = false;
+    bool error = false;
+
+    bool refill();
+};
+
+// Blanks within a line: what isspace() accepts, less '\n'
+inline bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// Field scanners over a line: each skips blanks, parses one field at p
+// and moves p past it, or returns false and leaves p alone. Numbers go
+// through std::from_chars, which neither allocates nor consults the
+// locale; a leading '+' is accepted as strtof and iostream accept it.
+template <typename T>
+inline bool scanNumber(const char*& p, const char* end, T& value) {
+    const char* q = p;
+    while (q != end && isBlank(*q)) ++q;
+    if (q != end && *q == '+' && q + 1 != end && q[1] != '-') ++q;
+    std::from_chars_result r = std::from_chars(q, end, value);
+    if (r.ec != std::errc()) return false;
+    p = r.ptr;
+    return true;
+}
+
+inline bool scanFloat(const char*& p, const char* end, float& value) { return scanNumber(p, end, value); }
+inline bool scanLong(const char*& p, const char* end, long& value) { return scanNumber(p, end, value); }
+
+// The next run of non-blanks as [word, wordEnd); false at the end of the line
+inline bool scanWord(const char*& p, const char* end, const char*& word, const char*& wordEnd) {
+    while (p != end && isBlank(*p)) ++p;
+    if (p == end) return false;
+    word = p;
+    while (p != end && !isBlank(*p)) ++p;
+    wordEnd = p;
+    return true;
+}
+
+// The apps' input: a point count, then that many "x y" pairs, separated
+// by any whitespace including newlines. False, with count 0 if there was
+// none and points holding what was read, if the input ends early or has
+// something other than a number where one is due.
+bool readCountedPoints(LineReader& lines, long& count, std::vector<Point>& points);
+
+#endif
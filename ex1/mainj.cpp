@@ -1,9 +1,58 @@
+#include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <ostream>
+#include <string>
 #include "convex_jarvis.hpp"
+#include "line_reader.hpp"
 #include "point.hpp"
 
-int main() {
+// Batch mode: the same input, read in large blocks and parsed with
+// std::from_chars, with no prompts; the answer goes out in one write
+static int runBatch(std::FILE* in) {
+    LineReader lines(in);
+    long n;
+    std::vector<Point> points;
+    if (!readCountedPoints(lines, n, points)) {
+        if (n < 3)
+            fputs("At least 3 points are required to form a convex hull.\n", stdout);
+        else
+            printf("Only %zu of %ld points could be read.\n", points.size(), n);
+        return 1;
+    }
+
+    ConvexJarvis cj(points);
+    cj.findConvexJarvis();
+    const std::vector<Point>& result = cj.chPoints;
+    double area = cj.polygonArea();
+
+    std::string out = "Convex Hull (Jarvis March):\n";
+    char text[64];
+    for (const auto& p : result) {
+        snprintf(text, sizeof(text), "(%g, %g)\n", p.getX(), p.getY());
+        out += text;
+    }
+    snprintf(text, sizeof(text), "area: %g\n", area);
+    out += text;
+    std::fwrite(out.data(), 1, out.size(), stdout);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    // --batch [file|-] reads the input non-interactively (stdin by default)
+    if (argc > 1 && strcmp(argv[1], "--batch") == 0) {
+        const char* path = argc > 2 ? argv[2] : "-";
+        std::FILE* in = strcmp(path, "-") == 0 ? stdin : std::fopen(path, "rb");
+        if (in == nullptr) {
+            perror(path);
+            return 1;
+        }
+        int status = runBatch(in);
+        if (in != stdin)
+            std::fclose(in);
+        return status;
+    }
+
     int n;
     std::cout << "Enter number of points: ";
     std::cin >> n;
@@ -0,0 +1,63 @@
+#ifndef PREDICATES_HPP
+#define PREDICATES_HPP
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include "point.hpp"
+
+// Calls and exact fallbacks since start or the last reset, over all threads
+struct OrientStats {
+    uint64_t calls;
+    uint64_t exact;
+};
+
+OrientStats orientStats();
+void resetOrientStats();
+
+// Per-thread counters behind orientStats(). Only the owning thread writes
+// them, so bumping is a plain load and store; other threads only read.
+struct OrientCounters {
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> exact;
+    bool registered;
+};
+
+extern thread_local OrientCounters orientCounters;
+
+void registerOrientCounters();
+int orient2dExact(float ax, float ay, float bx, float by, float cx, float cy);
+
+// Shewchuk's ccwerrboundA: a double determinant detLeft - detRight of
+// orientation has the right sign when its magnitude exceeds this fraction
+// of |detLeft| + |detRight|, or when either side is zero
+const double orientErrBound = (3.0 + 16.0 * 1.1102230246251565e-16) * 1.1102230246251565e-16;
+
+// Orientation of (a, b, c): +1 counterclockwise, -1 clockwise, 0 collinear.
+// Exact for every float input. The determinant is evaluated in double and
+// trusted when it clears Shewchuk's forward error bound (ccwerrboundA);
+// only uncertain cases fall back to orient2dExact().
+inline int orient2d(float ax, float ay, float bx, float by, float cx, float cy) {
+    OrientCounters& counters = orientCounters;
+    if (!counters.registered)
+        registerOrientCounters();
+    counters.calls.store(counters.calls.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+
+    double detLeft = (double(ax) - cx) * (double(by) - cy);
+    double detRight = (double(ay) - cy) * (double(bx) - cx);
+    double det = detLeft - detRight;
+
+    // Sides of opposite sign cannot cancel and always clear the bound; with
+    // a zero side the other one's sign is already exact
+    double bound = orientErrBound * (std::fabs(detLeft) + std::fabs(detRight));
+    if (std::fabs(det) > bound || detLeft == 0.0 || detRight == 0.0)
+        return (det > 0.0) - (det < 0.0);
+    return orient2dExact(ax, ay, bx, by, cx, cy);
+}
+
+inline int orient2d(const Point& a, const Point& b, const Point& c) {
+    return orient2d(a.getX(), a.getY(), b.getX(), b.getY(), c.getX(), c.getY());
+}
+
+#endif
@@ -0,0 +1,90 @@
+#include "prefilter.hpp"
+#include "predicates.hpp"
+#include <cmath>
+
+// A point just outside an octagon edge can be a hull vertex, so the double
+// cross product (b - a) x (c - a) only settles points clearly inside, and
+// the few others, kept points included, are decided by orient2d. Over a
+// w x h bounding box both products of an edge are capped, which makes
+// orient2d's error bound (doubled for slack) one margin per edge.
+static double edgeMargin(double dx, double dy, double w, double h) {
+    return 2.0 * orientErrBound * (std::fabs(dx) * h + std::fabs(dy) * w);
+}
+
+size_t aklToussaintFilter(const std::vector<Point>& in, std::vector<Point>& out) {
+    size_t n = in.size();
+    out.clear();
+    if (n < 9) {
+        out = in;
+        return 0;
+    }
+
+    // One pass over the points: index of the extreme in each direction,
+    // listed counterclockwise starting from the left
+    // 0: min x, 1: min x+y, 2: min y, 3: max x-y,
+    // 4: max x, 5: max x+y, 6: max y, 7: min x-y
+    float best[8];
+    size_t idx[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    {
+        float x = in[0].getX(), y = in[0].getY();
+        best[0] = x;     best[4] = x;
+        best[2] = y;     best[6] = y;
+        best[1] = x + y; best[5] = x + y;
+        best[3] = x - y; best[7] = x - y;
+    }
+    for (size_t i = 1; i < n; ++i) {
+        float x = in[i].getX(), y = in[i].getY();
+        float s = x + y, d = x - y;
+        idx[0] = x < best[0] ? i : idx[0]; best[0] = x < best[0] ? x : best[0];
+        idx[1] = s < best[1] ? i : idx[1]; best[1] = s < best[1] ? s : best[1];
+        idx[2] = y < best[2] ? i : idx[2]; best[2] = y < best[2] ? y : best[2];
+        idx[3] = d > best[3] ? i : idx[3]; best[3] = d > best[3] ? d : best[3];
+        idx[4] = x > best[4] ? i : idx[4]; best[4] = x > best[4] ? x : best[4];
+        idx[5] = s > best[5] ? i : idx[5]; best[5] = s > best[5] ? s : best[5];
+        idx[6] = y > best[6] ? i : idx[6]; best[6] = y > best[6] ? y : best[6];
+        idx[7] = d < best[7] ? i : idx[7]; best[7] = d < best[7] ? d : best[7];
+    }
+
+    // Octagon edges, skipping repeated vertices
+    double ex[8], ey[8], dx[8], dy[8];
+    const Point* from[8];
+    const Point* to[8];
+    int edges = 0;
+    for (int k = 0; k < 8; ++k) {
+        const Point& a = in[idx[k]];
+        const Point& b = in[idx[(k + 1) % 8]];
+        if (a == b) continue;
+        ex[edges] = a.getX();
+        ey[edges] = a.getY();
+        dx[edges] = static_cast<double>(b.getX()) - a.getX();
+        dy[edges] = static_cast<double>(b.getY()) - a.getY();
+        from[edges] = &a;
+        to[edges] = &b;
+        ++edges;
+    }
+    if (edges < 3) {
+        out = in;
+        return 0;
+    }
+
+    // Keep points on or outside the octagon
+    double w = double(best[4]) - best[0], h = double(best[6]) - best[2];
+    double margin[8];
+    for (int k = 0; k < edges; ++k)
+        margin[k] = edgeMargin(dx[k], dy[k], w, h);
+    out.reserve(n / 4);
+    for (size_t i = 0; i < n; ++i) {
+        double px = in[i].getX(), py = in[i].getY();
+        bool inside = true;
+        for (int k = 0; k < edges; ++k)
+            inside &= dx[k] * (py - ey[k]) - dy[k] * (px - ex[k]) > margin[k];
+        if (!inside) {
+            inside = true;
+            for (int k = 0; k < edges; ++k)
+                inside &= orient2d(*from[k], *to[k], in[i]) > 0;
+        }
+        if (!inside)
+            out.push_back(in[i]);
+    }
+    return n - out.size();
+}
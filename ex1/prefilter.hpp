@@ -0,0 +1,14 @@
+#ifndef PREFILTER_HPP
+#define PREFILTER_HPP
+
+#include <cstddef>
+#include <vector>
+#include "point.hpp"
+
+// Akl-Toussaint prefilter: copies to out every point of in that is not
+// strictly inside the octagon spanned by the extreme points in x, y, x+y
+// and x-y. Interior points can never be hull vertices, so any engine run
+// on out returns the same hull. Returns the number of points discarded.
+size_t aklToussaintFilter(const std::vector<Point>& in, std::vector<Point>& out);
+
+#endif
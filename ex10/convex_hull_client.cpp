@@ -33,7 +33,7 @@ int main(int argc, char* argv[]) {
 
     printf("Connected to Convex Hull server on %s:%d\n", server_ip, port);
     printf("Available commands:\n");
-    printf("  Newgraph\n  Newpoint x y\n  Removepoint x y\n  CH\n  EXIT\n\n");
+    printf("  Newgraph [scale]\n  Newpoint x y\n  Removepoint x y\n  CH\n  EXIT\n\n");
 
     char buffer[1024];
     
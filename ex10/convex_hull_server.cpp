@@ -9,14 +9,24 @@
 #include <unistd.h>
 #include <algorithm>
 #include <cmath>
+#include <string>
 #include <vector>
 #include <iostream>
 #include <thread>
 #include <mutex>
+#include <memory>
 #include <chrono>
 #include <pthread.h>
+#include "../ex3/arena.hpp"
+#include "../ex3/batch_hull.hpp"
 #include "../ex3/convex_hull.hpp"
+#include "../ex3/dynamic_hull.hpp"
+#include "../ex3/grid_hull.hpp"
+#include "../ex3/hull_cache.hpp"
 #include "../ex3/point.hpp"
+#include "../ex3/point_file.hpp"
+#include "../ex3/point_index.hpp"
+#include "../ex3/socket_io.hpp"
 #include "../ex8/reactor.hpp"
 
 
@@ -29,9 +39,19 @@ void* printerThread(void* arg);
 
 //------------------- Thread-safe Graph functions ------------------------------------
 
-// Global shared graph and convex hull object - WITH MUTEX PROTECTION
-std::vector<Point> shared_points;
-ConvexHull* ch = nullptr;
+// Global shared graph and its online hull - WITH MUTEX PROTECTION
+PointIndex shared_points; // the float graph, deduplicated in a cell grid
+DynamicHull online_hull;
+// A Loadgraph file: the float graph until it is edited, hulled in place
+std::unique_ptr<PointFile> loaded_points;
+ConvexHull loaded_hull;
+std::string data_dir; // --data-dir, where Loadgraph finds point files
+// Per-graph grid scale: 0 keeps float coordinates, otherwise points are
+// snapped to the integer grid and live only in grid_hull
+double grid_scale = 0.0;
+GridHull grid_hull;
+uint64_t graph_version = 0; // bumped by every change to either graph
+HullCache hull_cache;
 std::mutex graph_mutex;
 
 // Global variable to control server shutdown
@@ -47,6 +67,7 @@ bool ch_area_above_100 = false;
 bool ch_area_below_100 = false;
 bool area_above_processed = false;
 bool area_below_processed = false;
+double ch_area = 0.0; // area at the last CH, read by the printer thread
 pthread_t area_monitor_thread;
 pthread_t printer_thread;
 
@@ -70,23 +91,37 @@ void handle_sigint(int sig)
         stopProactor(proactor_thread);
     }
     
-    // Clean up memory
-    if (ch != nullptr) {
-        delete ch;
-        ch = nullptr;
-    }
-    
     printf("Server shut down gracefully.\n");
     exit(0);
 }
 
-void initializeGraph() {
+// Called with graph_mutex held. A loaded file stays mapped until the first
+// Newpoint or Removepoint, which copies it into the index and builds the
+// online hull from it, the one O(n log^2 n) step of a loaded graph.
+void materializeLoadedGraph() {
+    if (!loaded_points) return;
+    shared_points.assign(loaded_points->xData(), loaded_points->yData(), loaded_points->size());
+    loaded_points.reset();
+    online_hull.clear();
+    for (size_t i = 0; i < shared_points.size(); ++i)
+        online_hull.insert(shared_points[i]);
+}
+
+// Called with graph_mutex held
+size_t graphSize() {
+    if (grid_scale > 0.0)
+        return grid_hull.size();
+    return loaded_points ? loaded_points->size() : shared_points.size();
+}
+
+void initializeGraph(double scale = 0.0) {
     std::lock_guard<std::mutex> lock(graph_mutex);
-    if (ch != nullptr) {
-        delete ch;
-    }
+    loaded_points.reset();
     shared_points.clear();
-    ch = new ConvexHull(shared_points);
+    online_hull.clear();
+    ++graph_version;
+    grid_scale = scale;
+    grid_hull = GridHull(scale > 0.0 ? scale : 1.0);
     
     // Reset area flags when creating new graph
     pthread_mutex_lock(&area_mutex);
@@ -94,74 +129,181 @@ void initializeGraph() {
     ch_area_below_100 = false;
     area_above_processed = false;
     area_below_processed = false;
+    ch_area = 0.0;
     pthread_mutex_unlock(&area_mutex);
     
-    printf("New graph initialized\n");
+    if (grid_scale > 0.0)
+        printf("New graph initialized (grid scale %g)\n", grid_scale);
+    else
+        printf("New graph initialized\n");
 }
 
-void addPointToGraph(float x, float y) {
+// False only when a grid graph cannot hold the point
+bool addPointToGraph(double x, double y) {
     std::lock_guard<std::mutex> lock(graph_mutex);
-    
-    // Check if point already exists
-    for (const auto& p : shared_points) {
-        if (std::abs(p.getX() - x) < 0.001f && std::abs(p.getY() - y) < 0.001f) {
+
+    if (grid_scale > 0.0) {
+        GridPoint g;
+        if (!grid_hull.toGrid(x, y, g)) {
+            printf("Point (%.2f, %.2f) is outside the grid range\n", x, y);
+            return false;
+        }
+        if (grid_hull.contains(g)) {
             printf("Point (%.2f, %.2f) already exists, skipping\n", x, y);
-            return;
+            return true;
+        }
+        // Tested against the grid hull the cached snapshot was built from
+        bool inside = grid_hull.hullContains(g);
+        grid_hull.addPoint(g);
+        ++graph_version;
+        if (inside && hull_cache.carry(graph_version - 1, graph_version)) {
+            printf("Point is inside the hull, cached hull kept (%llu recomputes avoided)\n",
+                   (unsigned long long)hull_cache.getAvoidedRecomputes());
         }
+        printf("Added point (%.2f, %.2f) at grid (%d, %d). Total points: %zu\n", x, y, g.x, g.y,
+               grid_hull.size());
+        return true;
     }
     
-    shared_points.emplace_back(x, y);
-    if (ch != nullptr) {
-        delete ch;
+    materializeLoadedGraph();
+    // Check if point already exists: expected O(1) in the cell grid
+    if (shared_points.containsNear(float(x), float(y))) {
+        printf("Point (%.2f, %.2f) already exists, skipping\n", x, y);
+        return true;
+    }
+    
+    shared_points.add(Point(x, y));
+    // O(log^2 n) update of the maintained hull
+    online_hull.insert(shared_points.back());
+    // A point inside the cached hull or on its boundary cannot change it
+    const Point& added = shared_points.back();
+    bool inside = hull_cache.contains(graph_version, added.getX(), added.getY());
+    ++graph_version;
+    if (inside && hull_cache.carry(graph_version - 1, graph_version)) {
+        printf("Point is inside the hull, cached hull kept (%llu recomputes avoided)\n",
+               (unsigned long long)hull_cache.getAvoidedRecomputes());
     }
-    ch = new ConvexHull(shared_points);
     printf("Added point (%.2f, %.2f). Total points: %zu\n", x, y, shared_points.size());
+    return true;
 }
 
-void removePointFromGraph(float x, float y) {
+void removePointFromGraph(double x, double y) {
     std::lock_guard<std::mutex> lock(graph_mutex);
-    Point targetPoint(x, y);
-    auto it = std::remove_if(shared_points.begin(), shared_points.end(),
-        [&targetPoint](const Point& p) {
-            return std::abs(p.getX() - targetPoint.getX()) < 0.001f && 
-                   std::abs(p.getY() - targetPoint.getY()) < 0.001f;
-        });
+    if (grid_scale > 0.0) {
+        GridPoint g;
+        if (grid_hull.toGrid(x, y, g) && grid_hull.removePoint(g)) {
+            bool vertex = grid_hull.isHullVertex(g);
+            ++graph_version;
+            if (!vertex && hull_cache.carry(graph_version - 1, graph_version)) {
+                printf("No hull vertex removed, cached hull kept (%llu recomputes avoided)\n",
+                       (unsigned long long)hull_cache.getAvoidedRecomputes());
+            }
+            printf("Removed point (%.2f, %.2f). Total points: %zu\n", x, y, grid_hull.size());
+        } else {
+            printf("Point (%.2f, %.2f) not found\n", x, y);
+        }
+        return;
+    }
+    materializeLoadedGraph();
+    // Each match leaves the maintained hull too; points hidden under a
+    // removed hull vertex resurface inside the structure
+    bool hull_kept = true;
+    size_t removed = shared_points.removeNear(float(x), float(y), [&hull_kept](const Point& p) {
+        if (hull_cache.isVertex(graph_version, p.getX(), p.getY()))
+            hull_kept = false;
+        online_hull.remove(p);
+    });
     
-    if (it != shared_points.end()) {
-        shared_points.erase(it, shared_points.end());
-        if (ch != nullptr) {
-            delete ch;
+    if (removed > 0) {
+        ++graph_version;
+        if (hull_kept && hull_cache.carry(graph_version - 1, graph_version)) {
+            printf("No hull vertex removed, cached hull kept (%llu recomputes avoided)\n",
+                   (unsigned long long)hull_cache.getAvoidedRecomputes());
         }
-        ch = new ConvexHull(shared_points);
         printf("Removed point (%.2f, %.2f). Total points: %zu\n", x, y, shared_points.size());
     } else {
         printf("Point (%.2f, %.2f) not found\n", x, y);
     }
 }
 
-std::pair<std::vector<Point>, double> computeConvexHullSafe() {
+// Loadgraph name: replaces the graph with the point file (point_file.hpp)
+// of that name under data_dir, as a float graph. The file is mapped, not
+// parsed; see materializeLoadedGraph().
+std::string loadGraph(const char* name) {
+    std::string path, error;
+    if (!resolvePointFilePath(data_dir, name, path, error))
+        return std::string("Cannot load ") + name + ": " + error + "\n";
+    std::unique_ptr<PointFile> file(new PointFile);
+    if (!file->open(path.c_str()))
+        return std::string("Cannot load ") + name + ": " + file->error() + "\n";
+    if (file->size() > PointIndex::maxSize)
+        return std::string("Cannot load ") + name + ": too many points\n";
+
+    std::lock_guard<std::mutex> lock(graph_mutex);
+    shared_points.clear();
+    online_hull.clear();
+    grid_scale = 0.0;
+    grid_hull = GridHull(1.0);
+    loaded_points = std::move(file);
+    ++graph_version;
+    const PointFileHeader& h = loaded_points->header();
+    printf("Loaded %zu points from %s, bounds (%.2f, %.2f) - (%.2f, %.2f)\n", loaded_points->size(),
+           path.c_str(), h.minX, h.minY, h.maxX, h.maxY);
+    return "Graph loaded with " + std::to_string(loaded_points->size()) + " points\n";
+}
+
+// Hull vertices in world coordinates (double, so grid graphs keep full
+// precision), area and reply. Only the first CH after a change rebuilds
+// them; the snapshot stays valid after the lock is released.
+HullCache::Snapshot computeConvexHullSafe() {
     std::lock_guard<std::mutex> lock(graph_mutex);
     
-    std::vector<Point> hull_points;
-    double area = 0.0;
-    
-    if (shared_points.size() >= 3 && ch != nullptr) {
-        printf("Computing convex hull for %zu points...\n", shared_points.size());
-        ch->findConvexHull();
-        hull_points = ch->getConvexHullPoints();
-        area = ch->polygonArea();
+    size_t count = graphSize();
+    HullCache::Snapshot hull = hull_cache.lookup(graph_version);
+    if (!hull) {
+        std::vector<std::pair<double, double>> hull_points;
+        double area = 0.0;
+        // Exact integer hull, rebuilt on the first CH after a change. Also
+        // below 3 points, so the grid hull always matches the snapshot the
+        // Newpoint/Removepoint fast path keeps.
+        if (grid_scale > 0.0)
+            grid_hull.findConvexHull();
+        if (count >= 3) {
+            if (grid_scale > 0.0) {
+                for (const auto& g : grid_hull.getGridHull())
+                    hull_points.emplace_back(grid_hull.worldX(g), grid_hull.worldY(g));
+                area = grid_hull.polygonArea();
+            } else if (loaded_points) {
+                loaded_hull.findConvexHull(loaded_points->xData(), loaded_points->yData(),
+                                           loaded_points->size());
+                for (const auto& p : loaded_hull.getConvexHullPoints())
+                    hull_points.emplace_back(p.getX(), p.getY());
+                area = loaded_hull.polygonArea();
+            } else {
+                // Kept current by every Newpoint and Removepoint, so nothing is recomputed here
+                for (const auto& p : online_hull.hull())
+                    hull_points.emplace_back(p.getX(), p.getY());
+                area = online_hull.area();
+            }
         
-        printf("Computed convex hull with %zu points, area: %.2f\n", hull_points.size(), area);
-        if (hull_points.size() > 0) {
-            for (const auto& p : hull_points) {
-                printf("  (%.2f, %.2f)\n", p.getX(), p.getY());
+            printf("Computed convex hull with %zu points, area: %.2f\n", hull_points.size(), area);
+            if (hull_points.size() > 0) {
+                for (const auto& p : hull_points) {
+                    printf("  (%.2f, %.2f)\n", p.first, p.second);
+                }
+            } else {
+                printf("  No convex hull points (collinear points)\n");
             }
-        } else {
-            printf("  No convex hull points (collinear points)\n");
         }
+        hull = hull_cache.store(graph_version, std::move(hull_points), area);
+    }
+    
+    if (count >= 3) {
+        double area = hull->area;
         
         // Check area conditions for producer-consumer
         pthread_mutex_lock(&area_mutex);
+        ch_area = area;
         bool was_above_100 = ch_area_above_100;
         
                 if (area >= 100.0) {
@@ -214,12 +356,27 @@ std::pair<std::vector<Point>, double> computeConvexHullSafe() {
         pthread_mutex_unlock(&area_mutex);
     }
     
-    return {hull_points, area};
+    return hull;
 }
 
 void printCurrentGraph() {
     std::lock_guard<std::mutex> lock(graph_mutex);
-    printf("Current graph has %zu points:\n", shared_points.size());
+    if (grid_scale > 0.0) {
+        printf("Current graph has %zu points (grid scale %g):\n", grid_hull.size(), grid_scale);
+        for (size_t i = 0; i < grid_hull.size(); ++i) {
+            GridPoint g = grid_hull.at(i);
+            printf("  %zu: (%.2f, %.2f)\n", i+1, grid_hull.worldX(g), grid_hull.worldY(g));
+        }
+        return;
+    }
+    printf("Current graph has %zu points:\n", graphSize());
+    if (loaded_points) {
+        const float* xs = loaded_points->xData();
+        const float* ys = loaded_points->yData();
+        for (size_t i = 0; i < loaded_points->size(); ++i)
+            printf("  %zu: (%.2f, %.2f)\n", i+1, xs[i], ys[i]);
+        return;
+    }
     for (size_t i = 0; i < shared_points.size(); ++i) {
         printf("  %zu: (%.2f, %.2f)\n", i+1, shared_points[i].getX(), shared_points[i].getY());
     }
@@ -227,9 +384,14 @@ void printCurrentGraph() {
 
 size_t getPointCount() {
     std::lock_guard<std::mutex> lock(graph_mutex);
-    return shared_points.size();
+    return graphSize();
 }
 
+//------------------- Bulk hulls -------------------------------------------
+
+// Independent of the shared graph, so bulk requests take no lock
+BatchHull batch_hull;
+
 //------------------------------------------------------------------------
 
 void* handleClient(int client_fd) {
@@ -237,15 +399,17 @@ void* handleClient(int client_fd) {
     
     // Send welcome message
     const char* welcome = "Connected to Convex Hull Server\n"
-                         "Commands: Newgraph, Newpoint x y, Removepoint x y, CH\n";
+                         "Commands: Newgraph [scale], Newpoint x y, Removepoint x y, CH, Loadgraph name, Bulk sets points\n";
     send(client_fd, welcome, strlen(welcome), 0);
     
+    // Bytes received but not handled yet, from which commands are taken a
+    // line at a time: a Bulk request may span several reads, and what
+    // follows a command or a Bulk payload starts the next one
+    std::string pending, line;
     while (running) {
-        char buffer[256];
-        ssize_t len = read(client_fd, buffer, sizeof(buffer) - 1);
-
-        if (len <= 0) {
-            if (len == 0) {
+        int got = readLine(client_fd, pending, line);
+        if (got <= 0) {
+            if (got == 0) {
                 printf("[Thread %lu] Client disconnected gracefully: fd=%d\n", std::hash<std::thread::id>{}(std::this_thread::get_id()), client_fd);
             } else {
                 printf("[Thread %lu] Client connection error: fd=%d (%s)\n", std::hash<std::thread::id>{}(std::this_thread::get_id()), client_fd, strerror(errno));
@@ -253,18 +417,28 @@ void* handleClient(int client_fd) {
             break;
         }
 
-        buffer[len] = '\0';
+        // Hull engine scratch comes from the arena and is dropped when the
+        // request is done. A recomputed CH reply is a heap string owned by
+        // the HullCache snapshot, so the first CH after a change allocates.
+        ArenaScope scope;
+
+        // Bulk is followed by a binary payload, so it is taken before the cleanup below
+        if (line.compare(0, 5, "Bulk ") == 0) {
+            printf("[Thread %lu] Received command: '%s'\n", std::hash<std::thread::id>{}(std::this_thread::get_id()), line.c_str());
+            if (!serveBulk(client_fd, line, pending, batch_hull))
+                break;
+            continue;
+        }
         
         // Clean non-printable characters
-        char cleaned[256];
-        int j = 0;
-        for (int k = 0; k < len && j < 255; k++) {
-            if (buffer[k] >= 32 && buffer[k] <= 126) {
-                cleaned[j++] = buffer[k];
+        char buffer[maxCommandLine + 1];
+        size_t j = 0;
+        for (size_t k = 0; k < line.size() && j < maxCommandLine; k++) {
+            if (line[k] >= 32 && line[k] <= 126) {
+                buffer[j++] = line[k];
             }
         }
-        cleaned[j] = '\0';
-        strcpy(buffer, cleaned);
+        buffer[j] = '\0';
         
         printf("[Thread %lu] Received command: '%s'\n", std::hash<std::thread::id>{}(std::this_thread::get_id()), buffer);
 
@@ -274,12 +448,27 @@ void* handleClient(int client_fd) {
             const char* response = "New graph created\n";
             send(client_fd, response, strlen(response), 0);
         }
+        else if (strncmp(buffer, "Newgraph ", 9) == 0) {
+            // Grid graph: coordinates are snapped to multiples of scale
+            double scale;
+            if (sscanf(buffer + 9, "%lf", &scale) == 1 && scale > 0.0) {
+                initializeGraph(scale);
+                char response[128];
+                snprintf(response, sizeof(response), "New graph created (grid scale %g)\n", scale);
+                send(client_fd, response, strlen(response), 0);
+            } else {
+                const char* error = "Invalid format. Use: Newgraph [scale > 0]\n";
+                send(client_fd, error, strlen(error), 0);
+            }
+        }
         else if (strncmp(buffer, "Newpoint ", 9) == 0) {
-            float x, y;
-            if (sscanf(buffer + 9, "%f %f", &x, &y) == 2) {
-                addPointToGraph(x, y);
+            double x, y;
+            if (sscanf(buffer + 9, "%lf %lf", &x, &y) == 2) {
                 char response[128];
-                snprintf(response, sizeof(response), "Point (%.2f, %.2f) added\n", x, y);
+                if (addPointToGraph(x, y))
+                    snprintf(response, sizeof(response), "Point (%.2f, %.2f) added\n", x, y);
+                else
+                    snprintf(response, sizeof(response), "Point (%.2f, %.2f) is outside the grid range\n", x, y);
                 send(client_fd, response, strlen(response), 0);
             } else {
                 const char* error = "Invalid format. Use: Newpoint x y\n";
@@ -287,8 +476,8 @@ void* handleClient(int client_fd) {
             }
         }
         else if (strncmp(buffer, "Removepoint ", 12) == 0) {
-            float x, y;
-            if (sscanf(buffer + 12, "%f %f", &x, &y) == 2) {
+            double x, y;
+            if (sscanf(buffer + 12, "%lf %lf", &x, &y) == 2) {
                 size_t old_size = getPointCount();
                 removePointFromGraph(x, y);
                 if (getPointCount() < old_size) {
@@ -305,31 +494,23 @@ void* handleClient(int client_fd) {
                 send(client_fd, error, strlen(error), 0);
             }
         }
+        else if (strncmp(buffer, "Loadgraph ", 10) == 0) {
+            std::string response = loadGraph(buffer + 10);
+            send(client_fd, response.data(), response.size(), 0);
+        }
         else if (strcmp(buffer, "CH") == 0) {
-            auto [hull_points, area] = computeConvexHullSafe();
+            HullCache::Snapshot hull = computeConvexHullSafe();
             
-            if (hull_points.empty()) {
+            if (hull->hull.empty()) {
                 const char* error = "Need at least 3 points to compute convex hull\n";
                 send(client_fd, error, strlen(error), 0);
             } else {
-                char response[1024];
-                int offset = snprintf(response, sizeof(response), 
-                                     "Convex Hull (%zu points):\n", hull_points.size());
-
-                for (const auto& p : hull_points) {
-                    offset += snprintf(response + offset, sizeof(response) - offset,
-                                      "(%.2f, %.2f)\n", p.getX(), p.getY());
-                }
-
-                offset += snprintf(response + offset, sizeof(response) - offset,
-                                  "Area: %.2f\n", area);
-
-                send(client_fd, response, offset, 0);
+                send(client_fd, hull->reply.data(), hull->reply.size(), 0);
             }
         }
         else {
             printf("[Thread %lu] Unknown command: '%s'\n", std::hash<std::thread::id>{}(std::this_thread::get_id()), buffer);
-            const char* error = "Unknown command. Available: Newgraph, Newpoint x y, Removepoint x y, CH\n";
+            const char* error = "Unknown command. Available: Newgraph [scale], Newpoint x y, Removepoint x y, CH, Loadgraph name, Bulk sets points\n";
             send(client_fd, error, strlen(error), 0);
         }
     }
@@ -420,7 +601,7 @@ void* printerThread(void* arg) {
             printf("[Printer Thread] CH area crossed threshold below 100! Printing to stdout.\n");
             printf("=== CH AREA ALERT ===\n");
             printf("The Convex Hull area has crossed threshold below 100 units!\n");
-            printf("Current area: %.2f units\n", ch ? ch->polygonArea() : 0.0);
+            printf("Current area: %.2f units\n", ch_area);
             printf("=====================\n");
             
             area_below_processed = true; // Mark as processed
@@ -439,13 +620,25 @@ void* printerThread(void* arg) {
 //------------------------------------------------------------------------
 int main(int argc, char *argv[])
 {
-    if (argc != 2) {
-        fprintf(stderr, "Usage: %s <port>\n", argv[0]);
+    // <port> [--data-dir dir]; Loadgraph only reads point files under the
+    // data directory, and is off without one
+    bool args_ok = argc >= 2;
+    for (int i = 2; i < argc && args_ok; ++i) {
+        if (strcmp(argv[i], "--data-dir") == 0 && i + 1 < argc)
+            data_dir = argv[++i];
+        else
+            args_ok = false;
+    }
+    if (!args_ok) {
+        fprintf(stderr, "Usage: %s <port> [--data-dir dir]\n", argv[0]);
         return 1;
     }
 
     signal(SIGINT, handle_sigint);
 
+    // Loaded graphs are hulled by the engine picked from a sample
+    loaded_hull.setAlgorithm(ConvexHull::Algorithm::Auto);
+
     // Initialize graph
     initializeGraph();
     
@@ -485,9 +678,12 @@ int main(int argc, char *argv[])
     printf("Convex Hull Server (Producer-Consumer) running on port %d...\n", port);
     printf("Available commands:\n");
     printf("  Newgraph - Create new empty graph\n");
+    printf("  Newgraph scale - Create new graph on an integer grid of step scale\n");
     printf("  Newpoint x y - Add point to graph\n");
     printf("  Removepoint x y - Remove point from graph\n");
     printf("  CH - Compute convex hull\n");
+    printf("  Loadgraph name - Replace graph with a binary point file from the data directory\n");
+    printf("  Bulk sets points - Hulls of many point sets sent as binary CSR\n");
 
     // Store listen_fd globally for signal handler
     ::listen_fd = listen_fd;
@@ -552,10 +748,6 @@ int main(int argc, char *argv[])
     printf("Waiting for connections to close...\n");
     std::this_thread::sleep_for(std::chrono::seconds(2));
     
-    if (ch != nullptr) {
-        delete ch;
-    }
-    
     printf("Server terminated.\n");
     return 0;
 }
\ No newline at end of file
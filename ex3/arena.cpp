@@ -0,0 +1,127 @@
+#include "arena.hpp"
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+static std::atomic<uint64_t> heapBlocks(0);
+static std::atomic<uint64_t> heapBytes(0);
+static std::atomic<uint64_t> baseBlocks(0);
+static std::atomic<uint64_t> baseBytes(0);
+
+ArenaStats arenaStats() {
+    ArenaStats s = {heapBlocks.load(std::memory_order_relaxed) - baseBlocks.load(std::memory_order_relaxed),
+                    heapBytes.load(std::memory_order_relaxed) - baseBytes.load(std::memory_order_relaxed)};
+    return s;
+}
+
+void resetArenaStats() {
+    baseBlocks.store(heapBlocks.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    baseBytes.store(heapBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+Arena& threadArena() {
+    static thread_local Arena arena;
+    return arena;
+}
+
+Arena::~Arena() {
+    release();
+}
+
+static inline size_t alignUp(const char* base, size_t offset, size_t align) {
+    uintptr_t p = reinterpret_cast<uintptr_t>(base) + offset;
+    return offset + ((align - p % align) % align);
+}
+
+void* Arena::allocate(size_t bytes, size_t align) {
+    ++allocations;
+    if (current < blocks.size()) {
+        Block& b = blocks[current];
+        size_t start = alignUp(b.data, offset, align);
+        if (start + bytes <= b.size) {
+            offset = start + bytes;
+            return b.data + start;
+        }
+    }
+    return allocateSlow(bytes, align);
+}
+
+// Moves on to the next block that fits, replacing one that is too small
+// with a bigger one; blocks past the current one are free
+void* Arena::allocateSlow(size_t bytes, size_t align) {
+    size_t next = blocks.empty() ? 0 : current + 1;
+    if (next < blocks.size() && blocks[next].size < bytes + align) {
+        ::operator delete(blocks[next].data);
+        blocks.erase(blocks.begin() + next);
+    }
+    if (next >= blocks.size() || blocks[next].size < bytes + align) {
+        size_t size = blockSize;
+        if (!blocks.empty() && blocks.back().size > size)
+            size = blocks.back().size;
+        if (size < bytes + align)
+            size = bytes + align;
+        Block b = {static_cast<char*>(::operator new(size)), size};
+        blocks.insert(blocks.begin() + next, b);
+        heapBlocks.fetch_add(1, std::memory_order_relaxed);
+        heapBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+    current = next;
+    Block& b = blocks[current];
+    size_t start = alignUp(b.data, 0, align);
+    offset = start + bytes;
+    return b.data + start;
+}
+
+void Arena::deallocate(void* p, size_t bytes) {
+    if (current < blocks.size() && static_cast<char*>(p) + bytes == blocks[current].data + offset)
+        offset = static_cast<size_t>(static_cast<char*>(p) - blocks[current].data);
+}
+
+void Arena::rewind(const Mark& m) {
+    current = m.block;
+    offset = m.offset;
+}
+
+void Arena::release() {
+    for (const Block& b : blocks)
+        ::operator delete(b.data);
+    blocks.clear();
+    current = 0;
+    offset = 0;
+}
+
+size_t Arena::getCapacity() const {
+    size_t total = 0;
+    for (const Block& b : blocks)
+        total += b.size;
+    return total;
+}
+
+void ArenaText::appendf(const char* fmt, ...) {
+    va_list args, retry;
+    va_start(args, fmt);
+    va_copy(retry, args);
+
+    // Format into the spare room; only a result that does not fit is
+    // formatted a second time, after doubling
+    int len = vsnprintf(text + length, capacity - length, fmt, args);
+    if (len >= 0 && length + len >= capacity) {
+        size_t grown = capacity < 256 ? 256 : 2 * capacity;
+        while (grown <= length + len)
+            grown *= 2;
+        char* bigger = static_cast<char*>(arena.allocate(grown, 1));
+        if (length != 0)
+            std::memcpy(bigger, text, length);
+        arena.deallocate(text, capacity);
+        text = bigger;
+        capacity = grown;
+        vsnprintf(text + length, capacity - length, fmt, retry);
+    }
+    if (len > 0)
+        length += len;
+
+    va_end(retry);
+    va_end(args);
+}
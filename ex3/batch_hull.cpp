@@ -0,0 +1,160 @@
+#include "batch_hull.hpp"
+#include "hull_core.hpp"
+#include "simd_kernels.hpp"
+#include "thread_pool.hpp"
+#include "tiny_hull.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+typedef BasicConvexHull<float, Point> HullCore;
+
+const size_t BulkRequest::maxPoints;
+
+// Size and area of a hull written at hx, hy
+static void finishSet(const BatchHull::Output& out, size_t set, const float* hx, const float* hy,
+                      size_t h) {
+    out.sizes[set] = uint32_t(h);
+    out.areas[set] = h >= 3 ? std::abs(shoelaceSum(hx, hy, h)) / 2.0 : 0.0;
+}
+
+// Sets [begin, end). Scratch for sets above tinyHullMax is per chunk.
+static void runSets(const BatchHull::Input& in, const BatchHull::Output& out, size_t begin,
+                    size_t end) {
+    std::vector<Point> work, hull;
+    uint64_t lanes[4 * tinyHullMax], keys[tinyHullMax];
+    bool vectorSort = simdLevel() != SimdLevel::Scalar;
+    for (size_t i = begin; i < end;) {
+        size_t first = in.offsets[i], n = in.offsets[i + 1] - first;
+        const float* x = in.xs + first;
+        const float* y = in.ys + first;
+        float* hx = out.xs + first;
+        float* hy = out.ys + first;
+
+        if (n < 3) {
+            finishSet(out, i++, hx, hy, 0);
+            continue;
+        }
+
+        if (n > tinyHullMax) {
+            work.clear();
+            for (size_t k = 0; k < n; ++k)
+                work.push_back(Point(x[k], y[k]));
+            HullCore::monotone(work.data(), work.data() + n, hull);
+            for (size_t k = 0; k < hull.size(); ++k) {
+                hx[k] = hull[k].getX();
+                hy[k] = hull[k].getY();
+            }
+            finishSet(out, i++, hx, hy, hull.size());
+            continue;
+        }
+
+        // Four sets of this size in a row: one network sorts all of them
+        bool sameSize = vectorSort && i + 4 <= end;
+        for (size_t s = 1; sameSize && s < 4; ++s)
+            sameSize = in.offsets[i + s + 1] - in.offsets[i + s] == n;
+        if (sameSize) {
+            for (size_t s = 0; s < 4; ++s) {
+                const float* sx = in.xs + in.offsets[i + s];
+                const float* sy = in.ys + in.offsets[i + s];
+                for (size_t k = 0; k < n; ++k)
+                    lanes[4 * k + s] = packKeys(sx[k], sy[k]);
+            }
+            sortKeyLanes(lanes, n);
+            for (size_t s = 0; s < 4; ++s, ++i) {
+                for (size_t k = 0; k < n; ++k)
+                    keys[k] = lanes[4 * k + s];
+                float* sx = out.xs + in.offsets[i];
+                float* sy = out.ys + in.offsets[i];
+                finishSet(out, i, sx, sy, tinyChain(keys, n, sx, sy));
+            }
+            continue;
+        }
+
+        for (size_t k = 0; k < n; ++k)
+            keys[k] = packKeys(x[k], y[k]);
+        finishSet(out, i++, hx, hy, tinyHull(keys, n, hx, hy));
+    }
+}
+
+void BatchHull::run(const Input& in, const Output& out) {
+    unsigned threads = threadCount != 0 ? threadCount : std::thread::hardware_concurrency();
+    if (threads <= 1 || in.sets < parallelCutoff) {
+        runSets(in, out, 0, in.sets);
+        return;
+    }
+    // Several chunks per thread, since set sizes may vary a lot
+    ThreadPool pool(threads);
+    pool.parallelFor(in.sets, size_t(threads) * 4, [&](size_t, size_t begin, size_t end) {
+        runSets(in, out, begin, end);
+    });
+}
+
+bool BatchHull::validOffsets(const uint32_t* offsets, size_t sets, size_t points) {
+    if (offsets[0] != 0 || offsets[sets] != points)
+        return false;
+    for (size_t i = 0; i < sets; ++i) {
+        if (offsets[i + 1] < offsets[i])
+            return false;
+    }
+    return true;
+}
+
+bool BulkRequest::parseHeader(const char* line) {
+    unsigned long long s = 0, p = 0;
+    if (sscanf(line, "Bulk %llu %llu", &s, &p) != 2 || s > maxPoints || p > maxPoints)
+        return false;
+    sets = size_t(s);
+    points = size_t(p);
+    bytes.resize((sets + 1) * sizeof(uint32_t) + 2 * points * sizeof(float));
+    return true;
+}
+
+bool BulkRequest::solve(BatchHull& batch, std::string& reply) {
+    const char* p = bytes.data();
+    offsets.resize(sets + 1);
+    xs.resize(points);
+    ys.resize(points);
+    memcpy(offsets.data(), p, offsets.size() * sizeof(uint32_t));
+    p += offsets.size() * sizeof(uint32_t);
+    memcpy(xs.data(), p, points * sizeof(float));
+    memcpy(ys.data(), p + points * sizeof(float), points * sizeof(float));
+    if (!BatchHull::validOffsets(offsets.data(), sets, points)) {
+        reply = "Invalid Bulk offsets\n";
+        return false;
+    }
+
+    hx.resize(points);
+    hy.resize(points);
+    sizes.resize(sets);
+    areas.resize(sets);
+    BatchHull::Input in = {offsets.data(), xs.data(), ys.data(), sets};
+    BatchHull::Output out = {hx.data(), hy.data(), sizes.data(), areas.data()};
+    batch.run(in, out);
+
+    // Hull i sits at offsets[i]; the reply packs them back to back
+    std::vector<uint32_t> hullOffsets(sets + 1, 0);
+    for (size_t i = 0; i < sets; ++i)
+        hullOffsets[i + 1] = hullOffsets[i] + sizes[i];
+    size_t vertices = hullOffsets[sets];
+
+    char line[64];
+    snprintf(line, sizeof(line), "Bulk %zu %zu\n", sets, vertices);
+    reply = line;
+    size_t head = reply.size();
+    reply.resize(head + (sets + 1) * sizeof(uint32_t) + 2 * vertices * sizeof(float) +
+                 sets * sizeof(double));
+    char* q = &reply[head];
+    memcpy(q, hullOffsets.data(), hullOffsets.size() * sizeof(uint32_t));
+    q += hullOffsets.size() * sizeof(uint32_t);
+    for (const std::vector<float>* coords : {&hx, &hy}) {
+        for (size_t i = 0; i < sets; ++i) {
+            memcpy(q, coords->data() + offsets[i], sizes[i] * sizeof(float));
+            q += sizes[i] * sizeof(float);
+        }
+    }
+    memcpy(q, areas.data(), sets * sizeof(double));
+    return true;
+}
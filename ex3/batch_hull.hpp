@@ -0,0 +1,78 @@
+#ifndef BATCH_HULL_HPP
+#define BATCH_HULL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Hulls and areas of many independent point sets in one call. The input
+// is CSR: set i is points [offsets[i], offsets[i + 1]) of the shared xs
+// and ys arrays. A hull never has more vertices than its set, so set i's
+// hull goes to offsets[i] onwards in caller-owned arrays as long as the
+// input, and nothing is allocated per set. Chunks of sets run in parallel
+// on a thread pool. Sets of at most tinyHullMax points take the
+// tiny_hull.hpp kernels; runs of four consecutive sets of one such size
+// are sorted together by sortKeyLanes(). Hulls follow the chPoints
+// contract, areas are those of polygonArea().
+class BatchHull {
+public:
+    struct Input {
+        const uint32_t* offsets; // sets + 1 entries, rising from 0
+        const float* xs;
+        const float* ys;
+        size_t sets;
+    };
+
+    struct Output {
+        float* xs;       // offsets[sets] entries each
+        float* ys;
+        uint32_t* sizes; // hull vertices per set, 0 below 3
+        double* areas;
+    };
+
+    void run(const Input& in, const Output& out);
+
+    // True if offsets is a CSR index of points entries over sets sets
+    static bool validOffsets(const uint32_t* offsets, size_t sets, size_t points);
+
+    // Batches of fewer sets than the cutoff run on the calling thread
+    void setThreadCount(unsigned threads) { threadCount = threads; }
+    void setParallelCutoff(size_t sets) { parallelCutoff = sets; }
+
+private:
+    unsigned threadCount = 0;        // 0 = one per hardware thread
+    size_t parallelCutoff = 1 << 10;
+};
+
+// The servers' Bulk command. A request is the line "Bulk <sets> <points>"
+// followed by the CSR input as raw arrays in host byte order: sets + 1
+// uint32 offsets, points float x, points float y. The reply is the line
+// "Bulk <sets> <vertices>" followed by the hulls in the same layout, the
+// offsets indexing the concatenated vertices, then sets double areas.
+class BulkRequest {
+public:
+    static const size_t maxPoints = 1 << 24;
+
+    // Reads the header line (up to '\n' or the end); false if it is
+    // malformed or over maxPoints
+    bool parseHeader(const char* line);
+
+    // Where the payload goes, once parseHeader() succeeded
+    size_t payloadSize() const { return bytes.size(); }
+    char* payload() { return bytes.data(); }
+
+    // Runs the batch over the payload and formats the reply; false, with
+    // an error line as reply, if the offsets are not a valid CSR index
+    bool solve(BatchHull& batch, std::string& reply);
+
+private:
+    size_t sets = 0;
+    size_t points = 0;
+    std::vector<char> bytes;
+    std::vector<uint32_t> offsets, sizes;
+    std::vector<float> xs, ys, hx, hy;
+    std::vector<double> areas;
+};
+
+#endif
@@ -0,0 +1,739 @@
+// Benchmark for the ConvexHull engines on synthetic point sets
+// Usage: ./convex_hull_bench [n] [repeats]
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "arena.hpp"
+#include "batch_hull.hpp"
+#include "convex_hull.hpp"
+#include "engine_selector.hpp"
+#include "dynamic_hull.hpp"
+#include "grid_hull.hpp"
+#include "hull_core.hpp"
+#include "incremental_hull.hpp"
+#include "point.hpp"
+#include "point_index.hpp"
+#include "point_soa.hpp"
+#include "predicates.hpp"
+#include "radix_sort.hpp"
+#include "simd_kernels.hpp"
+#include "thread_pool.hpp"
+#include "tiny_hull.hpp"
+
+// Every global operator new in the process, so the request benchmark can
+// tell whether a warmed-up request still reaches malloc
+static std::atomic<uint64_t> heapCalls(0);
+
+void* operator new(size_t size) {
+    heapCalls.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size != 0 ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+struct Dataset {
+    const char* name;
+    std::vector<Point> points;
+};
+
+// The sequential engines on Point, as ConvexHull runs them
+typedef BasicConvexHull<float, Point> HullCore;
+
+// Caller-side record with payload, hulled in place by BasicConvexHull
+struct Sample {
+    float x, y;
+    uint32_t id;
+};
+
+struct Engine {
+    const char* name;
+    ConvexHull::Algorithm algo;
+    bool prefilter;
+};
+
+static const Engine engines[] = {
+    {"graham", ConvexHull::Algorithm::Graham, false},
+    {"graham-key", ConvexHull::Algorithm::GrahamKeyed, false},
+    {"monotone", ConvexHull::Algorithm::MonotoneChain, false},
+    {"quickhull", ConvexHull::Algorithm::QuickHull, false},
+    {"divide", ConvexHull::Algorithm::DivideAndConquer, false},
+    {"pf+graham", ConvexHull::Algorithm::Graham, true},
+    {"pf+monotone", ConvexHull::Algorithm::MonotoneChain, true},
+    {"pf+quickhull", ConvexHull::Algorithm::QuickHull, true},
+    {"auto", ConvexHull::Algorithm::Auto, false},
+};
+
+// Uniform points in a square
+static std::vector<Point> makeUniform(int n, std::mt19937& rng) {
+    std::uniform_real_distribution<float> d(-1000.0f, 1000.0f);
+    std::vector<Point> pts;
+    pts.reserve(n);
+    for (int i = 0; i < n; ++i)
+        pts.emplace_back(d(rng), d(rng));
+    return pts;
+}
+
+// Uniform points inside a disk
+static std::vector<Point> makeDisk(int n, std::mt19937& rng) {
+    std::uniform_real_distribution<float> d(0.0f, 1.0f);
+    std::vector<Point> pts;
+    pts.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        float r = 1000.0f * std::sqrt(d(rng));
+        float t = 2.0f * static_cast<float>(M_PI) * d(rng);
+        pts.emplace_back(r * std::cos(t), r * std::sin(t));
+    }
+    return pts;
+}
+
+// Points on a circle, so nearly every point is a hull vertex
+static std::vector<Point> makeCircle(int n, std::mt19937& rng) {
+    std::uniform_real_distribution<float> d(0.0f, 1.0f);
+    std::vector<Point> pts;
+    pts.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        float t = 2.0f * static_cast<float>(M_PI) * d(rng);
+        pts.emplace_back(1000.0f * std::cos(t), 1000.0f * std::sin(t));
+    }
+    return pts;
+}
+
+// Integer grid points on a few lines, many collinear and duplicate points
+static std::vector<Point> makeCollinear(int n, std::mt19937& rng) {
+    std::uniform_int_distribution<int> d(-1000, 1000);
+    std::uniform_int_distribution<int> line(0, 3);
+    std::vector<Point> pts;
+    pts.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        float v = static_cast<float>(d(rng));
+        switch (line(rng)) {
+            case 0: pts.emplace_back(v, -1000.0f); break;
+            case 1: pts.emplace_back(1000.0f, v); break;
+            case 2: pts.emplace_back(v, v); break;
+            default: pts.emplace_back(-1000.0f, v); break;
+        }
+    }
+    return pts;
+}
+
+// Best-of-repeats time of fn() in milliseconds
+template <typename Scalar>
+struct XY {
+    Scalar x, y;
+    bool operator==(const XY& o) const { return x == o.x && y == o.y; }
+};
+
+// Points along seven rays from (-300, -200), the lowest point, with copies
+// of it; graham and monotone must return the same hull
+template <typename Scalar>
+static bool sameOnRays(std::mt19937& rng, std::uniform_int_distribution<int>& t) {
+    static const int rays[][2] = {{1, 0}, {4, 1}, {1, 1}, {1, 4}, {0, 1}, {-1, 3}, {-1, 1}};
+    std::vector<XY<Scalar>> pts;
+    for (int i = 0; i < 4000; ++i) {
+        const int* u = rays[i % 7];
+        int k = i % 50 == 0 ? 0 : t(rng);
+        pts.push_back({Scalar(-300 + k * u[0]), Scalar(-200 + k * u[1])});
+    }
+    std::shuffle(pts.begin(), pts.end(), rng);
+    std::vector<XY<Scalar>> work = pts, grahamHull, monotoneHull;
+    BasicConvexHull<Scalar, XY<Scalar>>::graham(work.data(), work.data() + work.size(), grahamHull);
+    work = pts;
+    BasicConvexHull<Scalar, XY<Scalar>>::monotone(work.data(), work.data() + work.size(), monotoneHull);
+    return grahamHull.size() > 2 && grahamHull == monotoneHull;
+}
+
+template <typename Fn>
+static double timeBest(int repeats, Fn fn) {
+    double best = 0.0;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        if (r == 0 || ms < best)
+            best = ms;
+    }
+    return best;
+}
+
+// SoA kernels at every level this CPU supports, plus the SoA prefilter path
+static void benchKernels(const Dataset& ds, int repeats) {
+    PointSoA soa(ds.points);
+    size_t n = soa.size();
+    std::vector<int8_t> signs(n);
+    SimdLevel top = simdLevel();
+
+    printf("\nSoA kernels (%s, %zu points, host supports %s)\n", ds.name, n, simdLevelName(top));
+    printf("%-8s %14s %14s %14s\n", "level", "orient (ms)", "shoelace (ms)", "extremes (ms)");
+    for (int l = static_cast<int>(SimdLevel::Scalar); l <= static_cast<int>(top); ++l) {
+        SimdLevel level = setSimdLevel(static_cast<SimdLevel>(l));
+        double orient = timeBest(repeats, [&]() {
+            orientationBatch(-1000.0f, -3.0f, 1000.0f, 7.0f, soa.xData(), soa.yData(), n, signs.data());
+        });
+        volatile double sink = 0.0;
+        double shoelace = timeBest(repeats, [&]() { sink = shoelaceSum(soa.xData(), soa.yData(), n); });
+        size_t idx[8];
+        double extremes = timeBest(repeats, [&]() { extremePoints(soa.xData(), soa.yData(), n, idx); });
+        (void)sink;
+        printf("%-8s %14.2f %14.2f %14.2f\n", simdLevelName(level), orient, shoelace, extremes);
+    }
+    setSimdLevel(top);
+
+    ConvexHull ch(std::vector<Point>{});
+    ch.setAlgorithm(ConvexHull::Algorithm::MonotoneChain);
+    ch.setPrefilter(true);
+    double ms = timeBest(repeats, [&]() { ch.findConvexHull(soa); });
+    printf("soa pf+monotone: %.2f ms, hull %zu, discarded %zu\n", ms,
+           ch.getConvexHullPoints().size(), ch.getPrefilterDiscarded());
+}
+
+// Best-of-repeats time of findConvexHull() in milliseconds
+static double timeEngine(const std::vector<Point>& pts, const Engine& engine, int repeats,
+                         std::vector<Point>& hull, size_t& discarded, unsigned threads = 0) {
+    double best = 0.0;
+    for (int r = 0; r < repeats; ++r) {
+        ConvexHull ch(pts);
+        ch.setAlgorithm(engine.algo);
+        ch.setPrefilter(engine.prefilter);
+        ch.setThreadCount(threads);
+        auto start = std::chrono::steady_clock::now();
+        ch.findConvexHull();
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        if (r == 0 || ms < best)
+            best = ms;
+        hull = ch.getConvexHullPoints();
+        discarded = ch.getPrefilterDiscarded();
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 1000000;
+    int repeats = argc > 2 ? atoi(argv[2]) : 3;
+    if (n < 3 || repeats < 1) {
+        fprintf(stderr, "Usage: %s [n >= 3] [repeats >= 1]\n", argv[0]);
+        return 1;
+    }
+
+    std::mt19937 rng(12345);
+    std::vector<Dataset> datasets;
+    datasets.push_back({"uniform", makeUniform(n, rng)});
+    datasets.push_back({"disk", makeDisk(n, rng)});
+    datasets.push_back({"circle", makeCircle(n, rng)});
+    datasets.push_back({"collinear", makeCollinear(n, rng)});
+
+    printf("n = %d, best of %d runs\n", n, repeats);
+    printf("%-10s %-13s %12s %8s %10s\n", "dataset", "engine", "time (ms)", "hull", "discarded");
+    std::vector<double> fastestFixed, autoMs;
+    for (const auto& ds : datasets) {
+        std::vector<Point> reference;
+        double fastest = 0.0;
+        for (const auto& e : engines) {
+            std::vector<Point> hull;
+            size_t discarded = 0;
+            double ms = timeEngine(ds.points, e, repeats, hull, discarded);
+            if (&e == &engines[0])
+                reference = hull;
+            if (e.algo == ConvexHull::Algorithm::Auto)
+                autoMs.push_back(ms);
+            else if (&e == &engines[0] || ms < fastest)
+                fastest = ms;
+            printf("%-10s %-13s %12.2f %8zu %10zu %s\n", ds.name, e.name, ms, hull.size(),
+                   discarded, hull == reference ? "" : "(differs from graham)");
+        }
+        fastestFixed.push_back(fastest);
+    }
+
+    // What Auto picks per dataset, against the fastest fixed engine above,
+    // with the built-in profiles and again after calibrating on this host
+    for (int calibrated = 0; calibrated < 2; ++calibrated) {
+        if (calibrated) {
+            auto start = std::chrono::steady_clock::now();
+            EngineSelector::calibrate();
+            auto end = std::chrono::steady_clock::now();
+            printf("\ncalibration took %.0f ms\n",
+                   std::chrono::duration<double, std::milli>(end - start).count());
+        }
+        printf("\nengine selector, %s profiles\n", calibrated ? "calibrated" : "built-in");
+        EngineSelector::printProfiles(std::cout);
+        printf("%-10s %9s %11s %-14s %10s %12s\n", "dataset", "interior", "hull share", "picked",
+               "auto (ms)", "fastest (ms)");
+        for (size_t d = 0; d < datasets.size(); ++d) {
+            const std::vector<Point>& pts = datasets[d].points;
+            EngineSelector::Features f = EngineSelector::sample(pts.data(), pts.size());
+            ConvexHull::Plan plan = EngineSelector::choose(pts.data(), pts.size());
+            std::vector<Point> hull;
+            size_t discarded = 0;
+            double ms = calibrated ? timeEngine(pts, engines[8], repeats, hull, discarded) : autoMs[d];
+            printf("%-10s %9.3f %11.4f %-14s %10.2f %12.2f\n", datasets[d].name, f.interior,
+                   f.hullShare, EngineSelector::planName(plan).c_str(), ms, fastestFixed[d]);
+        }
+    }
+
+    benchKernels(datasets[0], repeats);
+
+    // (x, y) presort on the uniform set: comparison sort against radix
+    printf("\npresort (%s, %zu points)\n", datasets[0].name, datasets[0].points.size());
+    printf("%-14s %12s\n", "sort", "time (ms)");
+    std::vector<Point> sorted;
+    double stdMs = timeBest(repeats, [&]() {
+        sorted = datasets[0].points;
+        std::sort(sorted.begin(), sorted.end(), [](const Point& a, const Point& b) {
+            if (a.getX() != b.getX())
+                return a.getX() < b.getX();
+            return a.getY() < b.getY();
+        });
+    });
+    printf("%-14s %12.2f\n", "std::sort", stdMs);
+    RadixSorter sorter;
+    double radixMs = timeBest(repeats, [&]() {
+        sorted = datasets[0].points;
+        sorter.sortByXY(sorted.data(), sorted.size());
+    });
+    printf("%-14s %12.2f\n", "radix", radixMs);
+    unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    if (hw > 1) {
+        ThreadPool pool(hw);
+        double poolMs = timeBest(repeats, [&]() {
+            sorted = datasets[0].points;
+            sorter.sortByXY(sorted.data(), sorted.size(), &pool);
+        });
+        printf("radix x%-7u %12.2f\n", hw, poolMs);
+    }
+
+    // Filtered orientation: how often one Graham run needs the exact
+    // fallback, and the filter's cost against a bare double determinant
+    printf("\norientation predicate (graham, one run)\n");
+    printf("%-10s %12s %10s %10s\n", "dataset", "calls", "exact", "exact (%)");
+    for (const auto& ds : datasets) {
+        ConvexHull ch(ds.points);
+        resetOrientStats();
+        ch.findConvexHull();
+        OrientStats stats = orientStats();
+        printf("%-10s %12llu %10llu %10.4f\n", ds.name, (unsigned long long)stats.calls,
+               (unsigned long long)stats.exact,
+               stats.calls != 0 ? 100.0 * stats.exact / stats.calls : 0.0);
+    }
+    const std::vector<Point>& tri = datasets[0].points;
+    long long sink = 0;
+    double plainMs = timeBest(repeats, [&]() {
+        for (size_t i = 0; i + 2 < tri.size(); ++i) {
+            double ax = tri[i].getX(), ay = tri[i].getY();
+            double v = (tri[i + 1].getX() - ax) * (tri[i + 2].getY() - ay) -
+                       (tri[i + 1].getY() - ay) * (tri[i + 2].getX() - ax);
+            sink += (v > 0) - (v < 0);
+        }
+    });
+    double filteredMs = timeBest(repeats, [&]() {
+        for (size_t i = 0; i + 2 < tri.size(); ++i)
+            sink += orient2d(tri[i], tri[i + 1], tri[i + 2]);
+    });
+    printf("%zu triples: double %.2f ms, filtered %.2f ms (checksum %lld)\n", tri.size() - 2,
+           plainMs, filteredMs, sink);
+
+    // Integer grid input: exact GridHull against the float prefilter path
+    {
+        std::uniform_int_distribution<int32_t> d(-(1 << 20), 1 << 20);
+        GridHull grid;
+        std::vector<Point> pts;
+        pts.reserve(n);
+        for (int i = 0; i < n; ++i) {
+            GridPoint g = {d(rng), d(rng)};
+            grid.addPoint(g);
+            pts.emplace_back(float(g.x), float(g.y));
+        }
+        double gridMs = timeBest(repeats, [&]() { grid.findConvexHull(); });
+        std::vector<Point> hull;
+        size_t discarded = 0;
+        double floatMs = timeEngine(pts, engines[6], repeats, hull, discarded);
+        printf("\ngrid ints (%d points): grid %.2f ms, hull %zu; %s %.2f ms, hull %zu %s\n", n,
+               gridMs, grid.getGridHull().size(), engines[6].name, floatMs, hull.size(),
+               grid.getConvexHullPoints() == hull ? "" : "(differs)");
+    }
+
+    // Template engines on a payload struct, in place, against copying the
+    // coordinates out into Points for ConvexHull
+    {
+        const std::vector<Point>& src = datasets[1].points;
+        std::vector<Sample> samples(src.size());
+        for (size_t i = 0; i < src.size(); ++i)
+            samples[i] = {src[i].getX(), src[i].getY(), uint32_t(i)};
+        std::vector<Sample> work, sampleHull;
+        double inPlaceMs = timeBest(repeats, [&]() {
+            work = samples;
+            BasicConvexHull<float, Sample>::monotone(work.data(), work.data() + work.size(), sampleHull);
+        });
+        double grahamMs = timeBest(repeats, [&]() {
+            work = samples;
+            BasicConvexHull<float, Sample>::graham(work.data(), work.data() + work.size(), sampleHull);
+        });
+        std::vector<Point> copyHull;
+        double copyMs = timeBest(repeats, [&]() {
+            std::vector<Point> pts;
+            pts.reserve(samples.size());
+            for (const auto& s : samples)
+                pts.emplace_back(s.x, s.y);
+            ConvexHull ch(pts);
+            ch.setAlgorithm(ConvexHull::Algorithm::MonotoneChain);
+            ch.findConvexHull();
+            copyHull = ch.getConvexHullPoints();
+        });
+        work = samples;
+        BasicConvexHull<float, Sample>::monotone(work.data(), work.data() + work.size(), sampleHull);
+        bool same = sampleHull.size() == copyHull.size();
+        for (size_t i = 0; same && i < sampleHull.size(); ++i)
+            same = Point(sampleHull[i].x, sampleHull[i].y) == copyHull[i] &&
+                   src[sampleHull[i].id] == copyHull[i];
+        printf("\npayload structs (%s): in-place monotone %.2f ms, graham %.2f ms, hull %zu;"
+               " copy to Point + monotone %.2f ms, hull %zu %s\n",
+               datasets[1].name, inPlaceMs, grahamMs, sampleHull.size(), copyMs, copyHull.size(),
+               same ? "" : "(differs)");
+    }
+
+    // Points on rays out of the pivot, repeats included: graham breaks the
+    // angle ties by Manhattan distance, which must agree with monotone for
+    // every scalar
+    {
+        std::uniform_int_distribution<int> t(0, 1000);
+        printf("\ncollinear rays: graham = monotone float %s, double %s, int32 %s\n",
+               sameOnRays<float>(rng, t) ? "yes" : "NO", sameOnRays<double>(rng, t) ? "yes" : "NO",
+               sameOnRays<int32_t>(rng, t) ? "yes" : "NO");
+    }
+
+    // Server pattern: a ConvexHull built over a copy of the points per
+    // request, against the view overload over the caller's vector
+    {
+        const std::vector<Point>& src = datasets[0].points;
+        size_t copyHull = 0;
+        double copyMs = timeBest(repeats, [&]() {
+            ConvexHull ch(src);
+            ch.setAlgorithm(ConvexHull::Algorithm::MonotoneChain);
+            ch.findConvexHull();
+            copyHull = ch.getConvexHullPoints().size();
+        });
+        ConvexHull view;
+        double viewMs = timeBest(repeats, [&]() { view.findConvexHull(src.data(), src.size()); });
+        size_t viewHull = view.getConvexHullPoints().size();
+        view.setPrefilter(true);
+        double viewPfMs = timeBest(repeats, [&]() { view.findConvexHull(src.data(), src.size()); });
+        printf("\nview (%s): copy + monotone %.2f ms, hull %zu; view %.2f ms, hull %zu;"
+               " view + prefilter %.2f ms, hull %zu\n",
+               datasets[0].name, copyMs, copyHull, viewMs, viewHull, viewPfMs,
+               view.getConvexHullPoints().size());
+    }
+
+    // Many tiny graphs, as from upstream detectors: the generic engines on
+    // a copy of each against ConvexHull, which hands them to tiny_hull.hpp
+    {
+        const size_t graphs = 1 << 12;
+        std::uniform_real_distribution<float> coord(-1000.0f, 1000.0f);
+        printf("\ntiny hulls (%zu uniform graphs per size; ns per hull)\n", graphs);
+        printf("%-4s %10s %10s %10s %8s\n", "n", "graham", "monotone", "tiny", "same");
+        for (size_t n = 3; n <= tinyHullMax; ++n) {
+            std::vector<Point> src;
+            src.reserve(graphs * n);
+            for (size_t i = 0; i < graphs * n; ++i)
+                src.emplace_back(coord(rng), coord(rng));
+            std::vector<Point> work, out;
+            size_t sink = 0;
+            auto generic = [&](bool monotone) {
+                for (size_t g = 0; g < graphs; ++g) {
+                    work.assign(src.begin() + g * n, src.begin() + (g + 1) * n);
+                    if (monotone)
+                        HullCore::monotone(work.data(), work.data() + n, out);
+                    else
+                        HullCore::graham(work.data(), work.data() + n, out);
+                    sink += out.size();
+                }
+            };
+            double grahamMs = timeBest(repeats, [&]() { generic(false); });
+            double monotoneMs = timeBest(repeats, [&]() { generic(true); });
+            ConvexHull ch;
+            double tinyMs = timeBest(repeats, [&]() {
+                for (size_t g = 0; g < graphs; ++g) {
+                    ch.findConvexHull(src.data() + g * n, n);
+                    sink += ch.getConvexHullPoints().size();
+                }
+            });
+            bool same = true;
+            for (size_t g = 0; g < graphs && same; ++g) {
+                work.assign(src.begin() + g * n, src.begin() + (g + 1) * n);
+                HullCore::monotone(work.data(), work.data() + n, out);
+                ch.findConvexHull(src.data() + g * n, n);
+                same = out == ch.getConvexHullPoints();
+            }
+            double scale = 1e6 / graphs;
+            printf("%-4zu %10.1f %10.1f %10.1f %8s\n", n, grahamMs * scale, monotoneMs * scale,
+                   tinyMs * scale, same ? "yes" : "NO");
+            (void)sink;
+        }
+    }
+
+    // Batches of independent small sets in CSR form: a ConvexHull per set
+    // against BatchHull, with and without the four-set sorting network
+    {
+        const size_t sets = 100000;
+        std::uniform_real_distribution<float> coord(-1000.0f, 1000.0f);
+        printf("\nbatch hulls (%zu sets; ns per set)\n", sets);
+        printf("%-10s %10s %10s %10s %10s %10s\n", "sizes", "per set", "batch 1t", "lanes 1t",
+               "batch", "threads");
+        for (int mixed = 0; mixed < 2; ++mixed) {
+            std::vector<uint32_t> offsets(1, 0);
+            std::vector<float> xs, ys;
+            for (size_t i = 0; i < sets; ++i) {
+                size_t n = mixed ? 4 + rng() % 13 : 8;
+                for (size_t k = 0; k < n; ++k) {
+                    xs.push_back(coord(rng));
+                    ys.push_back(coord(rng));
+                }
+                offsets.push_back(uint32_t(xs.size()));
+            }
+            std::vector<float> hx(xs.size()), hy(xs.size());
+            std::vector<uint32_t> sizes;
+            std::vector<double> areas;
+            sizes.resize(sets);
+            areas.resize(sets);
+            BatchHull::Input in = {offsets.data(), xs.data(), ys.data(), sets};
+            BatchHull::Output out = {hx.data(), hy.data(), sizes.data(), areas.data()};
+
+            double sum = 0.0;
+            double perSetMs = timeBest(repeats, [&]() {
+                for (size_t i = 0; i < sets; ++i) {
+                    std::vector<Point> pts;
+                    for (size_t k = offsets[i]; k < offsets[i + 1]; ++k)
+                        pts.emplace_back(xs[k], ys[k]);
+                    ConvexHull ch(pts);
+                    ch.findConvexHull();
+                    sum += ch.polygonArea();
+                }
+            });
+            BatchHull batch;
+            batch.setThreadCount(1);
+            SimdLevel top = simdLevel();
+            setSimdLevel(SimdLevel::Scalar);
+            double scalarMs = timeBest(repeats, [&]() { batch.run(in, out); });
+            setSimdLevel(top);
+            double lanesMs = timeBest(repeats, [&]() { batch.run(in, out); });
+            batch.setThreadCount(0);
+            double threadedMs = timeBest(repeats, [&]() { batch.run(in, out); });
+            double scale = 1e6 / sets;
+            printf("%-10s %10.1f %10.1f %10.1f %10.1f %10u\n", mixed ? "4..16" : "8",
+                   perSetMs * scale, scalarMs * scale, lanesMs * scale, threadedMs * scale,
+                   std::max(1u, std::thread::hardware_concurrency()));
+            (void)sum;
+        }
+    }
+
+    // One server CH request: view hull, the hull copied out under the lock,
+    // area and response text. With the arena, requests after the first
+    // should not touch the global heap; std::vector and std::string do.
+    {
+        const std::vector<Point>& src = datasets[1].points;
+        ConvexHull ch;
+        const int requests = 20;
+        size_t replyBytes = 0;
+        auto arenaRequest = [&]() {
+            ArenaScope scope;
+            ch.findConvexHull(src.data(), src.size());
+            ArenaVector<Point> hull(ch.getConvexHullPoints().begin(), ch.getConvexHullPoints().end());
+            ArenaText reply;
+            reply.appendf("Convex Hull (%zu points):\n", hull.size());
+            for (const auto& p : hull)
+                reply.appendf("(%.2f, %.2f)\n", p.getX(), p.getY());
+            reply.appendf("Area: %.2f\n", ch.polygonArea());
+            replyBytes = reply.size();
+        };
+        auto heapRequest = [&]() {
+            ch.findConvexHull(src.data(), src.size());
+            std::vector<Point> hull = ch.getConvexHullPoints();
+            std::string reply = "Convex Hull (" + std::to_string(hull.size()) + " points):\n";
+            char line[64];
+            for (const auto& p : hull) {
+                snprintf(line, sizeof(line), "(%.2f, %.2f)\n", p.getX(), p.getY());
+                reply += line;
+            }
+            snprintf(line, sizeof(line), "Area: %.2f\n", ch.polygonArea());
+            reply += line;
+            replyBytes = reply.size();
+        };
+
+        arenaRequest(); // warm up: scratch and arena blocks reach their high-water mark
+        heapRequest();
+        printf("\nCH requests (%s, view hull + %zu-byte reply, %d warm requests)\n",
+               datasets[1].name, replyBytes, requests);
+        printf("%-8s %12s %14s %12s\n", "reply", "time (ms)", "heap/request", "arena blocks");
+        for (int kind = 0; kind < 2; ++kind) {
+            resetArenaStats();
+            uint64_t before = heapCalls.load(std::memory_order_relaxed);
+            auto start = std::chrono::steady_clock::now();
+            for (int r = 0; r < requests; ++r)
+                kind == 0 ? arenaRequest() : heapRequest();
+            auto end = std::chrono::steady_clock::now();
+            double ms = std::chrono::duration<double, std::milli>(end - start).count() / requests;
+            double perRequest = double(heapCalls.load(std::memory_order_relaxed) - before) / requests;
+            printf("%-8s %12.2f %14.1f %12llu\n", kind == 0 ? "arena" : "heap", ms, perRequest,
+                   (unsigned long long)arenaStats().heapBlocks);
+        }
+    }
+
+    // Hull merge on the circle set, where both halves keep most points
+    std::vector<Point> lo, hi;
+    for (const auto& p : datasets[2].points)
+        (p.getX() < 0 ? lo : hi).push_back(p);
+    ConvexHull loHull(lo), hiHull(hi);
+    loHull.setAlgorithm(ConvexHull::Algorithm::MonotoneChain);
+    hiHull.setAlgorithm(ConvexHull::Algorithm::MonotoneChain);
+    loHull.findConvexHull();
+    hiHull.findConvexHull();
+    std::vector<Point> merged;
+    double mergeMs = timeBest(repeats, [&]() {
+        merged = ConvexHull::mergeHulls(loHull.getConvexHullPoints(), hiHull.getConvexHullPoints());
+    });
+    printf("\nmergeHulls (%s halves, %zu + %zu vertices): %.3f ms, hull %zu\n", datasets[2].name,
+           loHull.getConvexHullPoints().size(), hiHull.getConvexHullPoints().size(), mergeMs,
+           merged.size());
+
+    // Insert then delete stream, one point at a time with the hull read
+    // after each update: online structures against a monotone rebuild
+    const std::vector<Point>& stream = datasets[1].points;
+    size_t streamLen = std::min<size_t>(stream.size(), 5000);
+    std::vector<Point> removal(stream.begin(), stream.begin() + streamLen);
+    std::shuffle(removal.begin(), removal.end(), rng);
+    auto rebuildHull = [](const std::vector<Point>& graph) {
+        ConvexHull ch(graph);
+        ch.setAlgorithm(ConvexHull::Algorithm::MonotoneChain);
+        ch.findConvexHull();
+        return ch.getConvexHullPoints().size();
+    };
+    size_t h = 0;
+    double incMs = timeBest(repeats, [&]() {
+        IncrementalHull inc;
+        for (size_t i = 0; i < streamLen; ++i) {
+            inc.insert(stream[i]);
+            h += inc.hull().size();
+        }
+    });
+    double dynInsMs = 0.0, dynDelMs = 0.0;
+    for (int r = 0; r < repeats; ++r) {
+        DynamicHull dyn;
+        double ins = timeBest(1, [&]() {
+            for (size_t i = 0; i < streamLen; ++i) {
+                dyn.insert(stream[i]);
+                h += dyn.hull().size();
+            }
+        });
+        double del = timeBest(1, [&]() {
+            for (const auto& p : removal) {
+                dyn.remove(p);
+                h += dyn.hull().size();
+            }
+        });
+        if (r == 0 || ins < dynInsMs) dynInsMs = ins;
+        if (r == 0 || del < dynDelMs) dynDelMs = del;
+    }
+    std::vector<Point> graph;
+    double rebuildInsMs = timeBest(1, [&]() {
+        for (size_t i = 0; i < streamLen; ++i) {
+            graph.push_back(stream[i]);
+            h += rebuildHull(graph);
+        }
+    });
+    double rebuildDelMs = timeBest(1, [&]() {
+        for (const auto& p : removal) {
+            graph.erase(std::find(graph.begin(), graph.end(), p));
+            h += rebuildHull(graph);
+        }
+    });
+    printf("\nupdate stream (%s, %zu inserts then %zu deletes, hull read after each)\n",
+           datasets[1].name, streamLen, streamLen);
+    printf("%-12s %14s %14s\n", "structure", "insert (ms)", "delete (ms)");
+    printf("%-12s %14.2f %14s\n", "incremental", incMs, "-");
+    printf("%-12s %14.2f %14.2f\n", "dynamic", dynInsMs, dynDelMs);
+    printf("%-12s %14.2f %14.2f\n", "rebuild", rebuildInsMs, rebuildDelMs);
+    (void)h;
+
+    // Server mutations on the whole uniform set: Newpoint's duplicate check
+    // and Removepoint (then re-adding the point), linear scan against the
+    // cell grid index
+    {
+        const std::vector<Point>& src = datasets[0].points;
+        const size_t ops = 1000;
+        std::vector<Point> probes;
+        for (size_t i = 0; i < ops; ++i)
+            probes.push_back(src[rng() % src.size()]);
+        auto near = [](const Point& p, const Point& q) {
+            return std::abs(p.getX() - q.getX()) < 0.001f && std::abs(p.getY() - q.getY()) < 0.001f;
+        };
+
+        std::vector<Point> linear(src);
+        size_t found = 0;
+        double linearFindMs = timeBest(repeats, [&]() {
+            for (const auto& q : probes)
+                found += std::any_of(linear.begin(), linear.end(), [&](const Point& p) { return near(p, q); });
+        });
+        double linearRemoveMs = timeBest(1, [&]() {
+            for (const auto& q : probes) {
+                auto it = std::remove_if(linear.begin(), linear.end(), [&](const Point& p) { return near(p, q); });
+                linear.erase(it, linear.end());
+                linear.push_back(q);
+            }
+        });
+
+        PointIndex index;
+        index.reserve(src.size());
+        for (const auto& p : src)
+            index.add(p);
+        double indexFindMs = timeBest(repeats, [&]() {
+            for (const auto& q : probes)
+                found += index.containsNear(q.getX(), q.getY());
+        });
+        double indexRemoveMs = timeBest(1, [&]() {
+            for (const auto& q : probes) {
+                index.removeNear(q.getX(), q.getY());
+                index.add(q);
+            }
+        });
+        printf("\nserver mutations (%s, %zu points, %zu ops; us per op)\n", datasets[0].name,
+               src.size(), ops);
+        printf("%-8s %14s %14s\n", "graph", "duplicate", "remove + add");
+        printf("%-8s %14.2f %14.2f\n", "linear", linearFindMs * 1000.0 / ops, linearRemoveMs * 1000.0 / ops);
+        printf("%-8s %14.2f %14.2f\n", "index", indexFindMs * 1000.0 / ops, indexRemoveMs * 1000.0 / ops);
+        (void)found;
+    }
+
+    // Parallel engine thread scaling on the disk set: 1, 2, 4, ... hardware threads
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (const Engine* e : {&engines[3], &engines[4]}) {
+        printf("\n%s scaling (%s)\n", e->name, datasets[1].name);
+        printf("%-8s %12s %8s\n", "threads", "time (ms)", "speedup");
+        double base = 0.0;
+        for (unsigned t = 1;; t *= 2) {
+            if (t > maxThreads) t = maxThreads;
+            std::vector<Point> hull;
+            size_t discarded = 0;
+            double ms = timeEngine(datasets[1].points, *e, repeats, hull, discarded, t);
+            if (t == 1) base = ms;
+            printf("%-8u %12.2f %7.2fx\n", t, ms, base / ms);
+            if (t == maxThreads) break;
+        }
+    }
+    return 0;
+}
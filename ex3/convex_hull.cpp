@@ -1,76 +1,638 @@
 #include "convex_hull.hpp"
+#include "arena.hpp"
+#include "engine_selector.hpp"
+#include "hull_core.hpp"
+#include "hull_query.hpp"
+#include "predicates.hpp"
+#include "prefilter.hpp"
+#include "simd_kernels.hpp"
+#include "thread_pool.hpp"
+#include "tiny_hull.hpp"
 #include <algorithm>
 #include <cmath>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+
+// The sequential engines, instantiated for Point
+typedef BasicConvexHull<float, Point> HullCore;
 
 // Constructor
-ConvexHull::ConvexHull(std::vector<Point> graph) : graph(graph) {}
+ConvexHull::ConvexHull(std::vector<Point> graph) : graph(std::move(graph)) {}
 
 // Orientation of 3 points
 int ConvexHull::orientation(Point a, Point b, Point c) {
-    double v = a.getX() * (b.getY() - c.getY()) +
-               b.getX() * (c.getY() - a.getY()) +
-               c.getX() * (a.getY() - b.getY());
-    if (v < 0) return -1;
-    if (v > 0) return +1;
-    return 0;
+    return HullCore::orientation(a, b, c);
 }
 
 
+// The configured engine and prefilter, or under Auto the selector's pick
+void ConvexHull::planFor(const Point* pts, size_t n) {
+    if (algorithm == Algorithm::Auto) {
+        lastPlan = EngineSelector::choose(pts, n);
+        return;
+    }
+    lastPlan.algorithm = algorithm;
+    lastPlan.prefilter = prefilter;
+}
+
 void ConvexHull::findConvexHull() {
-    int n = graph.size();
+    // Engines may reorder their input; the prefilter hands them a filtered
+    // copy so graph keeps its interior points for later mutations
+    planFor(graph.data(), graph.size());
+    prefilterDiscarded = 0;
+    hullVersion = version;
+    if (graph.size() <= tinyHullMax) {
+        tinyHull(graph.data(), graph.size(), chPoints);
+        return;
+    }
+    if (!lastPlan.prefilter) {
+        runEngine(graph);
+        return;
+    }
+    prefilterDiscarded = aklToussaintFilter(graph, survivors);
+    runEngine(survivors);
+}
+
+
+void ConvexHull::updateConvexHull() {
+    if (hullVersion != version)
+        findConvexHull();
+}
+
+
+void ConvexHull::findConvexHull(const PointSoA& points) {
+    findConvexHull(points.xData(), points.yData(), points.size());
+}
+
+void ConvexHull::findConvexHull(const float* xs, const float* ys, size_t n) {
+    if (algorithm == Algorithm::Auto) {
+        lastPlan = EngineSelector::choose(xs, ys, n);
+    } else {
+        lastPlan.algorithm = algorithm;
+        lastPlan.prefilter = prefilter;
+    }
+    prefilterDiscarded = 0;
+    hullVersion = noVersion;
+    if (n <= tinyHullMax) {
+        tinyHull(xs, ys, n, chPoints);
+        return;
+    }
+    if (!lastPlan.prefilter) {
+        soaToPoints(xs, ys, n, survivors);
+        runEngine(survivors);
+        return;
+    }
+    prefilterDiscarded = aklToussaintFilter(xs, ys, n, survivors);
+    runEngine(survivors);
+}
+
+
+void ConvexHull::findConvexHull(const Point* points, size_t n) {
+    planFor(points, n);
+    prefilterDiscarded = 0;
+    hullVersion = noVersion;
+    if (n <= tinyHullMax) {
+        tinyHull(points, n, chPoints);
+        return;
+    }
+    if (!lastPlan.prefilter && lastPlan.algorithm != Algorithm::MonotoneChain &&
+        algorithm == Algorithm::Auto) {
+        survivors.assign(points, points + n);
+        runEngine(survivors);
+        return;
+    }
+    if (!lastPlan.prefilter) {
+        findConvexHullIndexed(points, n);
+        return;
+    }
+    prefilterDiscarded = aklToussaintFilter(points, n, survivors);
+    runEngine(survivors);
+}
+
+
+void ConvexHull::runEngine(std::vector<Point>& pts) {
+    switch (lastPlan.algorithm) {
+        case Algorithm::GrahamKeyed:
+            findConvexHullGrahamKeyed(pts.data(), pts.size());
+            break;
+        case Algorithm::MonotoneChain:
+            findConvexHullMonotone(pts);
+            break;
+        case Algorithm::QuickHull:
+            findConvexHullQuick(pts);
+            break;
+        case Algorithm::DivideAndConquer:
+            findConvexHullDivide(pts);
+            break;
+        case Algorithm::Graham:
+        default:
+            findConvexHullGraham(pts);
+            break;
+    }
+}
+
+
+void ConvexHull::findConvexHullGraham(std::vector<Point>& pts) {
+    HullCore::graham(pts.data(), pts.data() + pts.size(), chPoints);
+}
+
+
+// Graham scan without comparator arithmetic in the sort: one SIMD pass
+// computes a pseudo-angle and distance key per point, and (key, index)
+// pairs are radix sorted. Keys are only approximate, so runs whose angles
+// are too close to call are re-sorted with the exact lessAngle(); the
+// order, and so chPoints, is exactly the plain scan's. The points are
+// only read.
+void ConvexHull::findConvexHullGrahamKeyed(const Point* pts, size_t n) {
     chPoints.clear();
 
     if (n < 3) return;
 
-    Point p0 = *std::min_element(graph.begin(), graph.end(), [](Point a, Point b) {
-        return std::make_pair(a.getY(), a.getX()) < std::make_pair(b.getY(), b.getX());
+    Point p0 = *std::min_element(pts, pts + n, HullCore::lessYX);
+    ArenaScope scope;
+    ArenaVector<float> xs(n), ys(n);
+    ArenaVector<uint64_t> keys(n);
+    for (size_t i = 0; i < n; ++i) {
+        xs[i] = pts[i].getX();
+        ys[i] = pts[i].getY();
+    }
+    pseudoAngleKeys(xs.data(), ys.data(), n, p0.getX(), p0.getY(), keys.data());
+
+    unsigned threads = threadCount != 0 ? threadCount : std::thread::hardware_concurrency();
+    std::unique_ptr<ThreadPool> pool;
+    if (threads > 1 && n >= parallelCutoff)
+        pool.reset(new ThreadPool(threads));
+    sorter.sortIndexByKey(keys.data(), n, viewOrder, pool.get());
+
+    // Key angles are within 2^-25 of the exact ones: neighbours further
+    // apart than this are already in exact order. Runs closer than that
+    // are mostly collinear and already ordered by the distance half of
+    // the key, so they are only sorted when a check finds them out of order.
+    const float tie = 1.0f / (1 << 22);
+    uint32_t* order = viewOrder.data();
+    auto angle = [&keys](size_t i) { return keyFloat(uint32_t(keys[i] >> 32)); };
+    auto exact = [&](uint32_t a, uint32_t b) { return HullCore::lessAngle(p0, pts[a], pts[b]); };
+    size_t run = 0;
+    for (size_t i = 1; i <= n; ++i) {
+        if (i < n && angle(i) - angle(i - 1) <= tie)
+            continue;
+        if (i - run > 1 && !std::is_sorted(order + run, order + i, exact))
+            std::sort(order + run, order + i, exact);
+        run = i;
+    }
+
+    HullCore::grahamIndexed(pts, order, n, chPoints);
+}
+
+
+// Twice the signed area of (a, b, c): positive when c is left of a->b
+static double cross(const Point& a, const Point& b, const Point& c) {
+    double ax = a.getX(), ay = a.getY();
+    return (b.getX() - ax) * (c.getY() - ay) - (b.getY() - ay) * (c.getX() - ax);
+}
+
+// Andrew's monotone chain. Produces the same contract as the Graham scan:
+// clockwise order starting at the lowest (then leftmost) point, no collinear
+// vertices, and an empty result when fewer than 3 hull vertices exist.
+void ConvexHull::findConvexHullMonotone(std::vector<Point>& pts) {
+    chPoints.clear();
+
+    if (pts.size() < 3) return;
+
+    // Radix presort; large inputs split its histogram pass across threads
+    unsigned threads = threadCount != 0 ? threadCount : std::thread::hardware_concurrency();
+    std::unique_ptr<ThreadPool> pool;
+    if (threads > 1 && pts.size() >= parallelCutoff)
+        pool.reset(new ThreadPool(threads));
+    sorter.sortByXY(pts.data(), pts.size(), pool.get());
+    HullCore::chain(pts.data(), pts.size(), chPoints);
+
+    if (chPoints.size() < 3) {
+        chPoints.clear();
+        return;
+    }
+
+    HullCore::rotateToPivot(chPoints);
+}
+
+// Monotone chain over caller-owned points: the radix presort permutes
+// viewOrder instead of the points
+void ConvexHull::findConvexHullIndexed(const Point* pts, size_t n) {
+    chPoints.clear();
+
+    if (n < 3) return;
+
+    unsigned threads = threadCount != 0 ? threadCount : std::thread::hardware_concurrency();
+    std::unique_ptr<ThreadPool> pool;
+    if (threads > 1 && n >= parallelCutoff)
+        pool.reset(new ThreadPool(threads));
+    sorter.sortIndexByXY(pts, n, viewOrder, pool.get());
+    HullCore::chainIndexed(pts, viewOrder.data(), n, chPoints);
+
+    if (chPoints.size() < 3) {
+        chPoints.clear();
+        return;
+    }
+
+    HullCore::rotateToPivot(chPoints);
+}
+
+
+// Per-chunk state for the parallel QuickHull passes
+struct QuickHullChunk {
+    double best = -1.0;
+    double along = 0.0;
+    size_t bestIndex = 0;
+    size_t firstCount = 0;
+    size_t secondCount = 0;
+};
+
+static void runChunks(ThreadPool* pool, size_t n, size_t chunks,
+                      const std::function<void(size_t, size_t, size_t)>& body) {
+    if (pool != nullptr && chunks > 1)
+        pool->parallelFor(n, chunks, body);
+    else
+        body(0, 0, n);
+}
+
+// Splits src into first (side 1) and second (side 2), dropping side 0.
+// Counts per chunk, then writes each chunk at its prefix offset.
+template <typename Side>
+static void partitionSides(const std::vector<Point>& src, Side side,
+                           std::vector<Point>& first, std::vector<Point>& second,
+                           ThreadPool* pool, size_t chunks) {
+    std::vector<QuickHullChunk> part(chunks);
+    runChunks(pool, src.size(), chunks, [&](size_t chunk, size_t begin, size_t end) {
+        QuickHullChunk& r = part[chunk];
+        for (size_t i = begin; i < end; ++i) {
+            int s = side(src[i]);
+            if (s == 1) ++r.firstCount;
+            else if (s == 2) ++r.secondCount;
+        }
+    });
+    size_t firstTotal = 0, secondTotal = 0;
+    for (auto& r : part) {
+        size_t f = r.firstCount, sc = r.secondCount;
+        r.firstCount = firstTotal;
+        r.secondCount = secondTotal;
+        firstTotal += f;
+        secondTotal += sc;
+    }
+    first.resize(firstTotal);
+    second.resize(secondTotal);
+    runChunks(pool, src.size(), chunks, [&](size_t chunk, size_t begin, size_t end) {
+        size_t f = part[chunk].firstCount, sc = part[chunk].secondCount;
+        for (size_t i = begin; i < end; ++i) {
+            int s = side(src[i]);
+            if (s == 1) first[f++] = src[i];
+            else if (s == 2) second[sc++] = src[i];
+        }
     });
+}
+
+// Splits set (all strictly left of p->q) around its farthest point c into
+// the points left of p->c and left of c->q. Returns false if set is empty.
+static bool quickHullSplit(const Point& p, const Point& q, const std::vector<Point>& set,
+                           Point& c, std::vector<Point>& left, std::vector<Point>& right,
+                           ThreadPool* pool, size_t chunks) {
+    if (set.empty()) return false;
+    chunks = std::min(chunks, set.size());
+    std::vector<QuickHullChunk> part(chunks);
+    double dx = q.getX() - p.getX(), dy = q.getY() - p.getY();
 
-    std::sort(graph.begin(), graph.end(), [this, &p0](const Point& a, const Point& b) {
-        int o = orientation(p0, a, b);
-        if (o == 0)
-            return p0.distanceTo(a) < p0.distanceTo(b);
-        return o < 0;
+    // Farthest from p->q; among ties, the one closest to p along p->q
+    runChunks(pool, set.size(), chunks, [&](size_t chunk, size_t begin, size_t end) {
+        QuickHullChunk& r = part[chunk];
+        for (size_t i = begin; i < end; ++i) {
+            double d = cross(p, q, set[i]);
+            double a = (set[i].getX() - p.getX()) * dx + (set[i].getY() - p.getY()) * dy;
+            if (d > r.best || (d == r.best && a < r.along)) {
+                r.best = d;
+                r.along = a;
+                r.bestIndex = i;
+            }
+        }
     });
+    const QuickHullChunk* top = &part[0];
+    for (const auto& r : part) {
+        if (r.best > top->best || (r.best == top->best && r.along < top->along))
+            top = &r;
+    }
+    c = set[top->bestIndex];
+
+    partitionSides(set, [&](const Point& pt) {
+        if (orient2d(p, c, pt) > 0) return 1;
+        if (orient2d(c, q, pt) > 0) return 2;
+        return 0;
+    }, left, right, pool, chunks);
+    return true;
+}
+
+// Appends the hull vertices strictly left of p->q (exclusive of p and q)
+// to out, in clockwise order. Consumes set.
+void ConvexHull::quickHullSide(const Point& p, const Point& q, std::vector<Point>& set,
+                               std::vector<Point>& out, ThreadPool* pool) {
+    // Parallel partitioning only near the top, where sets are large
+    bool parallel = pool != nullptr && set.size() >= parallelCutoff * pool->size();
+    size_t chunks = parallel ? pool->size() * 4 : 1;
+
+    Point c;
+    std::vector<Point> left, right;
+    if (!quickHullSplit(p, q, set, c, left, right, parallel ? pool : nullptr, chunks))
+        return;
+    std::vector<Point>().swap(set);
 
-    std::vector<Point> stack;
-    for (int i = 0; i < n; ++i) {
-        while (stack.size() > 1 &&
-               orientation(stack[stack.size() - 2], stack.back(), graph[i]) >= 0)
-            stack.pop_back();
-        stack.push_back(graph[i]);
+    if (pool != nullptr && left.size() >= parallelCutoff && right.size() >= parallelCutoff) {
+        std::vector<Point> leftOut;
+        ThreadPool::TaskGroup group;
+        pool->submit(group, [&]() { quickHullSide(p, c, left, leftOut, pool); });
+        std::vector<Point> rightOut;
+        quickHullSide(c, q, right, rightOut, pool);
+        pool->wait(group);
+        out.insert(out.end(), leftOut.begin(), leftOut.end());
+        out.push_back(c);
+        out.insert(out.end(), rightOut.begin(), rightOut.end());
+    } else {
+        quickHullSide(p, c, left, out, pool);
+        out.push_back(c);
+        quickHullSide(c, q, right, out, pool);
     }
+}
+
+// QuickHull with task-parallel recursion. Same chPoints contract as the
+// Graham scan. Inputs below parallelCutoff never start a thread.
+void ConvexHull::findConvexHullQuick(std::vector<Point>& pts) {
+    size_t n = pts.size();
+    chPoints.clear();
+
+    if (n < 3) return;
+
+    unsigned threads = threadCount != 0 ? threadCount : std::thread::hardware_concurrency();
+    std::unique_ptr<ThreadPool> pool;
+    if (threads > 1 && n >= parallelCutoff)
+        pool.reset(new ThreadPool(threads));
+
+    auto byXY = [](const Point& a, const Point& b) {
+        if (a.getX() != b.getX())
+            return a.getX() < b.getX();
+        return a.getY() < b.getY();
+    };
+    auto extremes = std::minmax_element(pts.begin(), pts.end(), byXY);
+    Point a = *extremes.first;
+    Point b = *extremes.second;
+    if (a == b) return;
+
+    // Points above and below the a-b line
+    std::vector<Point> upper, lower;
+    size_t chunks = pool ? pool->size() * 4 : 1;
+    partitionSides(pts, [&](const Point& pt) {
+        int d = orient2d(a, b, pt);
+        if (d > 0) return 1;
+        if (d < 0) return 2;
+        return 0;
+    }, upper, lower, pool.get(), chunks);
+
+    // Clockwise: a, upper chain, b, lower chain
+    std::vector<Point> hull;
+    hull.push_back(a);
+    std::vector<Point> lowerOut;
+    if (pool) {
+        ThreadPool::TaskGroup group;
+        pool->submit(group, [&]() { quickHullSide(b, a, lower, lowerOut, pool.get()); });
+        quickHullSide(a, b, upper, hull, pool.get());
+        pool->wait(group);
+    } else {
+        quickHullSide(a, b, upper, hull, nullptr);
+        quickHullSide(b, a, lower, lowerOut, nullptr);
+    }
+    hull.push_back(b);
+    hull.insert(hull.end(), lowerOut.begin(), lowerOut.end());
+
+    if (hull.size() < 3) return;
+
+    HullCore::rotateToPivot(hull);
+    chPoints = std::move(hull);
+}
+
+
+// Appends the vertices of a clockwise hull sorted by (x, y): the upper
+// chain runs clockwise from the leftmost to the rightmost vertex, the
+// lower chain counterclockwise between the same two
+static void appendSorted(const std::vector<Point>& hull, std::vector<Point>& out) {
+    size_t n = hull.size();
+    size_t lo = std::min_element(hull.begin(), hull.end(), HullCore::lessXY) - hull.begin();
+    size_t hi = std::max_element(hull.begin(), hull.end(), HullCore::lessXY) - hull.begin();
+    size_t first = out.size();
+    for (size_t i = lo;; i = (i + 1) % n) {
+        out.push_back(hull[i]);
+        if (i == hi) break;
+    }
+    size_t middle = out.size();
+    for (size_t i = (lo + n - 1) % n; i != hi; i = (i + n - 1) % n)
+        out.push_back(hull[i]);
+    std::inplace_merge(out.begin() + first, out.begin() + middle, out.end(), HullCore::lessXY);
+}
 
-    if (stack.size() >= 3)
-        chPoints = stack;
+// Hull of two hulls whose x ranges overlap: merge their sorted vertices
+// and run one monotone chain pass over them
+static std::vector<Point> mergeOverlapping(const std::vector<Point>& a, const std::vector<Point>& b) {
+    std::vector<Point> pts;
+    pts.reserve(a.size() + b.size());
+    appendSorted(a, pts);
+    appendSorted(b, pts);
+    std::inplace_merge(pts.begin(), pts.begin() + a.size(), pts.end(), HullCore::lessXY);
+    return HullCore::chain(pts.data(), pts.size());
 }
 
+// Hull of a and b when all of a lies strictly left of b. Walks the upper
+// and lower tangents from the facing extremes, then splices the outer
+// chains. On collinear ties the walk moves to the farther vertex so the
+// result keeps no collinear vertices.
+static std::vector<Point> mergeSeparated(const std::vector<Point>& a, const std::vector<Point>& b) {
+    size_t na = a.size(), nb = b.size();
+    auto next = [](size_t i, size_t n) { return (i + 1) % n; };
+    auto prev = [](size_t i, size_t n) { return (i + n - 1) % n; };
+    size_t right = std::max_element(a.begin(), a.end(), HullCore::lessXY) - a.begin();
+    size_t left = std::min_element(b.begin(), b.end(), HullCore::lessXY) - b.begin();
 
+    // Upper tangent: a counterclockwise, b clockwise, while the neighbour
+    // is above the bridge
+    size_t ua = right, ub = left;
+    for (bool moved = true; moved;) {
+        moved = false;
+        for (;;) {
+            const Point& c = a[prev(ua, na)];
+            int d = orient2d(a[ua], b[ub], c);
+            if (d < 0 || (d == 0 && c.getX() >= a[ua].getX())) break;
+            ua = prev(ua, na);
+            moved = true;
+        }
+        for (;;) {
+            const Point& c = b[next(ub, nb)];
+            int d = orient2d(a[ua], b[ub], c);
+            if (d < 0 || (d == 0 && c.getX() <= b[ub].getX())) break;
+            ub = next(ub, nb);
+            moved = true;
+        }
+    }
+
+    // Lower tangent: a clockwise, b counterclockwise, while the neighbour
+    // is below the bridge
+    size_t la = right, lb = left;
+    for (bool moved = true; moved;) {
+        moved = false;
+        for (;;) {
+            const Point& c = a[next(la, na)];
+            int d = orient2d(a[la], b[lb], c);
+            if (d > 0 || (d == 0 && c.getX() >= a[la].getX())) break;
+            la = next(la, na);
+            moved = true;
+        }
+        for (;;) {
+            const Point& c = b[prev(lb, nb)];
+            int d = orient2d(a[la], b[lb], c);
+            if (d > 0 || (d == 0 && c.getX() <= b[lb].getX())) break;
+            lb = prev(lb, nb);
+            moved = true;
+        }
+    }
+
+    // Clockwise: a from the lower to the upper tangent, then b back down
+    std::vector<Point> hull;
+    for (size_t i = la;; i = next(i, na)) {
+        hull.push_back(a[i]);
+        if (i == ua) break;
+    }
+    for (size_t i = ub;; i = next(i, nb)) {
+        hull.push_back(b[i]);
+        if (i == lb) break;
+    }
+    return hull;
+}
+
+// Linear-time merge that also accepts degenerate (one or two point) hulls
+static std::vector<Point> mergeChains(const std::vector<Point>& a, const std::vector<Point>& b) {
+    if (a.empty()) return b;
+    if (b.empty()) return a;
+    auto ax = std::minmax_element(a.begin(), a.end(), HullCore::lessXY);
+    auto bx = std::minmax_element(b.begin(), b.end(), HullCore::lessXY);
+    if (ax.second->getX() < bx.first->getX())
+        return mergeSeparated(a, b);
+    if (bx.second->getX() < ax.first->getX())
+        return mergeSeparated(b, a);
+    return mergeOverlapping(a, b);
+}
+
+std::vector<Point> ConvexHull::mergeHulls(const std::vector<Point>& a, const std::vector<Point>& b) {
+    std::vector<Point> hull = mergeChains(a, b);
+    if (hull.size() < 3) return std::vector<Point>();
+    HullCore::rotateToPivot(hull);
+    return hull;
+}
+
+// Hull of pts[begin, end) cut into slabs by (x, y). Each slab is sorted and
+// run through the monotone chain; neighbouring slab hulls are merged on
+// the way back up.
+static std::vector<Point> divideHull(std::vector<Point>& pts, size_t begin, size_t end,
+                                     size_t slabs, ThreadPool* pool) {
+    if (slabs <= 1) {
+        RadixSorter sorter;
+        sorter.sortByXY(pts.data() + begin, end - begin);
+        return HullCore::chain(pts.data() + begin, end - begin);
+    }
+    size_t leftSlabs = slabs / 2;
+    size_t mid = begin + (end - begin) * leftSlabs / slabs;
+    std::nth_element(pts.begin() + begin, pts.begin() + mid, pts.begin() + end, HullCore::lessXY);
+
+    std::vector<Point> left, right;
+    ThreadPool::TaskGroup group;
+    pool->submit(group, [&]() { left = divideHull(pts, begin, mid, leftSlabs, pool); });
+    right = divideHull(pts, mid, end, slabs - leftSlabs, pool);
+    pool->wait(group);
+    return mergeChains(left, right);
+}
+
+// Divide and conquer: one x-slab per thread, at least parallelCutoff
+// points each. Same chPoints contract as the Graham scan.
+void ConvexHull::findConvexHullDivide(std::vector<Point>& pts) {
+    size_t n = pts.size();
+    chPoints.clear();
+
+    if (n < 3) return;
+
+    unsigned threads = threadCount != 0 ? threadCount : std::thread::hardware_concurrency();
+    size_t slabs = std::max<size_t>(1, std::min<size_t>(threads, n / parallelCutoff));
+    std::unique_ptr<ThreadPool> pool;
+    if (slabs > 1)
+        pool.reset(new ThreadPool(threads));
+
+    std::vector<Point> hull = divideHull(pts, 0, n, slabs, pool.get());
+    if (hull.size() < 3) return;
+
+    HullCore::rotateToPivot(hull);
+    chPoints = std::move(hull);
+}
+
+
+// Shoelace formula through the SIMD kernel, on SoA scratch in the arena
 double ConvexHull::polygonArea() const {
-    double area = 0.0;
-    int n = chPoints.size();
-    for (int i = 0; i < n; ++i) {
-        const Point& p1 = chPoints[i];
-        const Point& p2 = chPoints[(i + 1) % n];
-        area += (p1.getX() * p2.getY()) - (p2.getX() * p1.getY());
+    ArenaScope scope;
+    ArenaVector<float> xs, ys;
+    xs.reserve(chPoints.size());
+    ys.reserve(chPoints.size());
+    for (const auto& p : chPoints) {
+        xs.push_back(p.getX());
+        ys.push_back(p.getY());
     }
-    return std::abs(area) / 2.0;
+    return std::abs(shoelaceSum(xs.data(), ys.data(), chPoints.size())) / 2.0;
+}
+
+static int orientPoints(const Point& a, const Point& b, const Point& c) {
+    return orient2d(a, b, c);
+}
+
+bool ConvexHull::hullContains(const Point& p) const {
+    return hullVersion == version &&
+           ::hullContains(chPoints.data(), chPoints.size(), p, orientPoints);
+}
+
+bool ConvexHull::isHullVertex(const Point& p) const {
+    return hullVersion == version &&
+           hullHasVertex(chPoints.data(), chPoints.size(), p, orientPoints);
 }
 
 // New methods for interactive functionality
 void ConvexHull::addPoint(const Point& point) {
+    // A point inside the hull or on its boundary cannot change it
+    bool keep = hullContains(point);
     graph.push_back(point);
+    ++version;
+    if (keep) {
+        hullVersion = version;
+        ++avoidedRecomputes;
+    }
 }
 
 void ConvexHull::removePoint(const Point& point) {
     auto it = std::find(graph.begin(), graph.end(), point);
     if (it != graph.end()) {
+        // Neither can removing a point that is not a vertex; a degenerate
+        // (empty) hull stays degenerate
+        bool keep = hullVersion == version && !isHullVertex(point);
         graph.erase(it);
+        ++version;
+        if (keep) {
+            hullVersion = version;
+            ++avoidedRecomputes;
+        }
     }
 }
 
 void ConvexHull::setGraph(const std::vector<Point>& newGraph) {
     graph = newGraph;
+    ++version;
 }
 
 void ConvexHull::printConvexHull() const {
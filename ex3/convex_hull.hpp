@@ -1,23 +1,119 @@
 #ifndef CONVEX_HULL_HPP
 #define CONVEX_HULL_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <vector>
 #include "point.hpp"
+#include "point_soa.hpp"
+#include "radix_sort.hpp"
+
+class ThreadPool;
 
 class ConvexHull {
+public:
+    // Hull engines available behind findConvexHull()
+    enum class Algorithm {
+        Graham,           // angular sort around the lowest point
+        GrahamKeyed,      // same scan, radix sorted on precomputed pseudo-angle keys
+        MonotoneChain,    // Andrew's monotone chain, sorted by (x, y)
+        QuickHull,        // farthest-point recursion, parallel on large inputs
+        DivideAndConquer, // x-slab hulls in parallel, merged pairwise
+        Auto              // EngineSelector picks per input from a sample
+    };
+
+    // Engine and prefilter setting for one run
+    struct Plan {
+        Algorithm algorithm;
+        bool prefilter;
+    };
+
 private:
     std::vector<Point> graph;    
     std::vector<Point> chPoints; 
+    uint64_t version = 0;              // bumped by every change to graph
+    uint64_t hullVersion = noVersion;  // graph version chPoints belongs to
+    uint64_t avoidedRecomputes = 0;    // mutations that kept chPoints current
+    Algorithm algorithm = Algorithm::Graham;
+    unsigned threadCount = 0;          // 0 = one per hardware thread
+    size_t parallelCutoff = 1 << 14;   // smaller subproblems run sequentially
+    bool prefilter = false;            // Akl-Toussaint stage before the engine
+    size_t prefilterDiscarded = 0;
+    Plan lastPlan = {Algorithm::Graham, false}; // what the last run used
+    RadixSorter sorter;                // (x, y) presort, scratch reused between runs
+    std::vector<uint32_t> viewOrder;   // index scratch of the view overload and keyed Graham
+    std::vector<Point> survivors;      // prefilter output, reused between runs
+
+    void planFor(const Point* pts, size_t n);
+    void runEngine(std::vector<Point>& pts);
+    void findConvexHullGraham(std::vector<Point>& pts);
+    void findConvexHullGrahamKeyed(const Point* pts, size_t n);
+    void findConvexHullMonotone(std::vector<Point>& pts);
+    void findConvexHullIndexed(const Point* pts, size_t n);
+    void findConvexHullQuick(std::vector<Point>& pts);
+    void findConvexHullDivide(std::vector<Point>& pts);
+    void quickHullSide(const Point& p, const Point& q, std::vector<Point>& set,
+                       std::vector<Point>& out, ThreadPool* pool);
 
 public:
+    ConvexHull() {}
     ConvexHull(std::vector<Point> graph);
     int orientation(Point a, Point b, Point c);
     
     void findConvexHull(); 
     double polygonArea() const;
 
+    // Graph version, bumped by addPoint, removePoint and setGraph
+    static const uint64_t noVersion = ~uint64_t(0);
+    uint64_t getVersion() const { return version; }
+
+    // findConvexHull() only if graph changed since the last hull of it
+    void updateConvexHull();
+
+    // O(log h) tests against the current hull; false while it is stale
+    bool hullContains(const Point& p) const;
+    bool isHullVertex(const Point& p) const;
+
+    // Inserts inside the hull and removals of non-vertices, which left an
+    // up to date hull as it was
+    uint64_t getAvoidedRecomputes() const { return avoidedRecomputes; }
+
+    // Hull of SoA points instead of graph. With the prefilter on, only the
+    // points that survive it are copied out of the container. The array
+    // form takes storage a PointSoA does not own, e.g. a mapped point file.
+    void findConvexHull(const PointSoA& points);
+    void findConvexHull(const float* xs, const float* ys, size_t n);
+
+    // Hull of caller-owned points, which are never reordered (n below
+    // 2^32). Without the prefilter this is the monotone chain, sorted
+    // through a scratch index buffer; with it, only the survivors are
+    // copied out and handed to the selected engine. Under Auto an engine
+    // other than the monotone chain runs on a scratch copy.
+    void findConvexHull(const Point* points, size_t n);
+
     const std::vector<Point>& getConvexHullPoints() const { return chPoints; }
+
+    // Hull of the union of two hulls in O(h1 + h2), without the raw points.
+    // Inputs are clockwise with no repeated vertices, e.g. the output of
+    // getConvexHullPoints(); the result follows the same contract.
+    static std::vector<Point> mergeHulls(const std::vector<Point>& a, const std::vector<Point>& b);
+
+    // Engine selection (Graham by default). Under Auto the selector also
+    // decides on the prefilter, and setPrefilter() is ignored. Inputs of
+    // at most tinyHullMax points skip both for the fixed-size kernels in
+    // tiny_hull.hpp, whatever the setting.
+    void setAlgorithm(Algorithm algo) { algorithm = algo; }
+    Algorithm getAlgorithm() const { return algorithm; }
+    Plan getLastPlan() const { return lastPlan; }
+
+    // Parallel tuning (QuickHull, DivideAndConquer, monotone chain presort)
+    void setThreadCount(unsigned threads) { threadCount = threads; }
+    void setParallelCutoff(size_t cutoff) { parallelCutoff = cutoff; }
+
+    // Akl-Toussaint prefilter ahead of any engine; the count is from the last run
+    void setPrefilter(bool enabled) { prefilter = enabled; }
+    size_t getPrefilterDiscarded() const { return prefilterDiscarded; }
     
     // New methods for interactive functionality
     void addPoint(const Point& point);
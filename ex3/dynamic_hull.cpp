@@ -0,0 +1,344 @@
+#include "dynamic_hull.hpp"
+#include "point_soa.hpp"
+#include "predicates.hpp"
+#include "simd_kernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+struct DynamicHullNode {
+    struct Vertex {
+        float x, y;
+    };
+
+    Vertex pt = {0.0f, 0.0f};   // leaf point
+    Vertex bridgeL = pt;        // internal: upper bridge, left end
+    Vertex bridgeR = pt;        // internal: upper bridge, right end
+    float lo = 0.0f, hi = 0.0f; // x range below
+    size_t size = 1;            // leaves below
+    DynamicHullNode* left = nullptr;
+    DynamicHullNode* right = nullptr;
+    DynamicHullNode* parent = nullptr;
+
+    bool leaf() const { return left == nullptr; }
+};
+
+typedef DynamicHullNode Node;
+typedef DynamicHullNode::Vertex Vertex;
+
+// Exact orientation of (a, b, c): positive when c is above a->b
+static int orientation(const Vertex& a, const Vertex& b, const Vertex& c) {
+    return orient2d(a.x, a.y, b.x, b.y, c.x, c.y);
+}
+
+// Bridge of the upper hulls under v->left and v->right. Both implicit
+// hulls are descended at once: x holds the left end, y the right end, and
+// every step moves one of them a level down, so this is O(height).
+static void findBridge(Node* v) {
+    const Node* x = v->left;
+    const Node* y = v->right;
+    double m = (double(x->hi) + double(y->lo)) / 2.0; // separates the two sides
+    for (;;) {
+        bool xLeaf = x->leaf(), yLeaf = y->leaf();
+        if (xLeaf && yLeaf) break;
+        const Vertex& a = xLeaf ? x->pt : x->bridgeL;
+        const Vertex& b = xLeaf ? x->pt : x->bridgeR;
+        const Vertex& c = yLeaf ? y->pt : y->bridgeL;
+        const Vertex& d = yLeaf ? y->pt : y->bridgeR;
+
+        // Right side reaches the line a-b: the left end is at or before a
+        if (!xLeaf && (orientation(a, b, c) >= 0 || orientation(a, b, d) >= 0)) {
+            x = x->left;
+            continue;
+        }
+        // Left side reaches the line c-d: the right end is at or after d
+        if (!yLeaf && (orientation(c, d, a) >= 0 || orientation(c, d, b) >= 0)) {
+            y = y->right;
+            continue;
+        }
+        if (xLeaf) {
+            y = y->left;
+        } else if (yLeaf) {
+            x = x->right;
+        } else {
+            // Both edges pass above the other side. The lines cross; if they
+            // cross left of m the left end is past b, otherwise the right
+            // end is before c.
+            double rx = double(b.x) - a.x, ry = double(b.y) - a.y;
+            double sx = double(d.x) - c.x, sy = double(d.y) - c.y;
+            double det = rx * sy - ry * sx; // < 0 here
+            double t = (double(c.x) - a.x) * sy - (double(c.y) - a.y) * sx;
+            if ((a.x - m) * det + t * rx >= 0)
+                x = x->right;
+            else
+                y = y->left;
+        }
+    }
+    v->bridgeL = x->pt;
+    v->bridgeR = y->pt;
+}
+
+static void pull(Node* v) {
+    v->size = v->left->size + v->right->size;
+    v->lo = v->left->lo;
+    v->hi = v->right->hi;
+    findBridge(v);
+}
+
+static Node* makeLeaf(float x, float y) {
+    Node* n = new Node;
+    n->pt = {x, y};
+    n->lo = n->hi = x;
+    return n;
+}
+
+static bool unbalanced(const Node* n) {
+    return 4 * std::max(n->left->size, n->right->size) > 3 * n->size;
+}
+
+static void destroy(Node* n) {
+    if (n == nullptr) return;
+    destroy(n->left);
+    destroy(n->right);
+    delete n;
+}
+
+// Leaves of n in x order; internal nodes are freed on the way
+static void collectLeaves(Node* n, std::vector<Node*>& leaves) {
+    if (n->leaf()) {
+        leaves.push_back(n);
+        return;
+    }
+    collectLeaves(n->left, leaves);
+    collectLeaves(n->right, leaves);
+    delete n;
+}
+
+static Node* build(const std::vector<Node*>& leaves, size_t begin, size_t end) {
+    if (end - begin == 1)
+        return leaves[begin];
+    size_t mid = begin + (end - begin) / 2;
+    Node* v = new Node;
+    v->left = build(leaves, begin, mid);
+    v->right = build(leaves, mid, end);
+    v->left->parent = v;
+    v->right->parent = v;
+    pull(v);
+    return v;
+}
+
+static void collectChain(const Node* v, float lo, float hi, bool negate, std::vector<Point>& out) {
+    if (v->leaf()) {
+        if (lo <= v->pt.x && v->pt.x <= hi)
+            out.emplace_back(v->pt.x, negate ? -v->pt.y : v->pt.y);
+        return;
+    }
+    if (lo <= v->bridgeL.x)
+        collectChain(v->left, lo, std::min(hi, v->bridgeL.x), negate, out);
+    if (hi >= v->bridgeR.x)
+        collectChain(v->right, std::max(lo, v->bridgeR.x), hi, negate, out);
+}
+
+DynamicHull::Chain::~Chain() {
+    destroy(root);
+}
+
+void DynamicHull::Chain::clear() {
+    destroy(root);
+    root = nullptr;
+}
+
+// Sets the chain point at x, adding a leaf if x is new
+void DynamicHull::Chain::assign(float x, float y) {
+    if (root == nullptr) {
+        root = makeLeaf(x, y);
+        return;
+    }
+    Node* n = root;
+    while (!n->leaf())
+        n = x <= n->left->hi ? n->left : n->right;
+    if (n->pt.x == x) {
+        n->pt.y = y;
+        fixUp(n->parent);
+        return;
+    }
+
+    // n becomes a sibling of the new leaf under a fresh internal node
+    Node* leaf = makeLeaf(x, y);
+    Node* inner = new Node;
+    inner->parent = n->parent;
+    if (n->parent == nullptr)
+        root = inner;
+    else if (n->parent->left == n)
+        n->parent->left = inner;
+    else
+        n->parent->right = inner;
+    inner->left = x < n->pt.x ? leaf : n;
+    inner->right = x < n->pt.x ? n : leaf;
+    leaf->parent = n->parent = inner;
+    fixUp(inner);
+}
+
+void DynamicHull::Chain::erase(float x) {
+    Node* n = root;
+    while (n != nullptr && !n->leaf())
+        n = x <= n->left->hi ? n->left : n->right;
+    if (n == nullptr || n->pt.x != x) return;
+
+    // The sibling takes the place of the parent
+    Node* p = n->parent;
+    if (p == nullptr) {
+        delete n;
+        root = nullptr;
+        return;
+    }
+    Node* sibling = p->left == n ? p->right : p->left;
+    delete n;
+    Node* g = p->parent;
+    sibling->parent = g;
+    if (g == nullptr)
+        root = sibling;
+    else if (g->left == p)
+        g->left = sibling;
+    else
+        g->right = sibling;
+    delete p;
+    fixUp(g);
+}
+
+// Refreshes the path from n to the root. Sizes go first so the highest
+// node that lost its weight balance can be rebuilt before bridges are
+// recomputed above it.
+void DynamicHull::Chain::fixUp(Node* n) {
+    Node* scapegoat = nullptr;
+    for (Node* p = n; p != nullptr; p = p->parent) {
+        p->size = p->left->size + p->right->size;
+        if (unbalanced(p))
+            scapegoat = p;
+    }
+    if (scapegoat != nullptr)
+        n = rebuild(scapegoat)->parent;
+    for (; n != nullptr; n = n->parent)
+        pull(n);
+}
+
+// Replaces the subtree at n with a perfectly balanced one
+Node* DynamicHull::Chain::rebuild(Node* n) {
+    Node* parent = n->parent;
+    bool wasLeft = parent != nullptr && parent->left == n;
+    std::vector<Node*> leaves;
+    collectLeaves(n, leaves);
+    Node* t = build(leaves, 0, leaves.size());
+    t->parent = parent;
+    if (parent == nullptr)
+        root = t;
+    else if (wasLeft)
+        parent->left = t;
+    else
+        parent->right = t;
+    return t;
+}
+
+void DynamicHull::Chain::vertices(std::vector<Point>& out, bool negate) const {
+    if (root != nullptr)
+        collectChain(root, root->lo, root->hi, negate, out);
+}
+
+DynamicHull::DynamicHull(const std::vector<Point>& points) {
+    for (const auto& p : points)
+        insert(p);
+}
+
+// Only the highest and lowest point of each x column reach the chains
+void DynamicHull::insert(const Point& p) {
+    float x = p.getX(), y = p.getY();
+    std::multiset<float>& column = columns[x];
+    if (column.empty() || y > *column.rbegin()) {
+        upper.assign(x, y);
+        dirty = true;
+    }
+    if (column.empty() || y < *column.begin()) {
+        lower.assign(x, -y);
+        dirty = true;
+    }
+    column.insert(y);
+    ++count;
+}
+
+bool DynamicHull::remove(const Point& p) {
+    float x = p.getX(), y = p.getY();
+    auto col = columns.find(x);
+    if (col == columns.end()) return false;
+    std::multiset<float>& column = col->second;
+    auto it = column.find(y);
+    if (it == column.end()) return false;
+
+    column.erase(it);
+    --count;
+    if (column.empty()) {
+        columns.erase(col);
+        upper.erase(x);
+        lower.erase(x);
+        dirty = true;
+        return true;
+    }
+    if (*column.rbegin() < y) {
+        upper.assign(x, *column.rbegin());
+        dirty = true;
+    }
+    if (*column.begin() > y) {
+        lower.assign(x, -*column.begin());
+        dirty = true;
+    }
+    return true;
+}
+
+void DynamicHull::clear() {
+    upper.clear();
+    lower.clear();
+    columns.clear();
+    count = 0;
+    vertices.clear();
+    cachedArea = 0.0;
+    dirty = false;
+}
+
+const std::vector<Point>& DynamicHull::hull() const {
+    if (dirty)
+        rebuild();
+    return vertices;
+}
+
+double DynamicHull::area() const {
+    if (dirty)
+        rebuild();
+    return cachedArea;
+}
+
+// Upper chain left to right, then the lower chain back, sharing endpoints
+void DynamicHull::rebuild() const {
+    dirty = false;
+    vertices.clear();
+    cachedArea = 0.0;
+    std::vector<Point> bottom;
+    upper.vertices(vertices, false);
+    lower.vertices(bottom, true);
+    for (auto it = bottom.rbegin(); it != bottom.rend(); ++it) {
+        if (!(*it == vertices.back()) && !(*it == vertices.front()))
+            vertices.push_back(*it);
+    }
+    if (vertices.size() < 3) {
+        vertices.clear();
+        return;
+    }
+
+    auto start = std::min_element(vertices.begin(), vertices.end(), [](const Point& a, const Point& b) {
+        if (a.getY() != b.getY())
+            return a.getY() < b.getY();
+        return a.getX() < b.getX();
+    });
+    std::rotate(vertices.begin(), start, vertices.end());
+
+    PointSoA soa(vertices);
+    cachedArea = std::abs(shoelaceSum(soa.xData(), soa.yData(), soa.size())) / 2.0;
+}
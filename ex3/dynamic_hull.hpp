@@ -0,0 +1,71 @@
+#ifndef DYNAMIC_HULL_HPP
+#define DYNAMIC_HULL_HPP
+
+#include <cstddef>
+#include <map>
+#include <set>
+#include <vector>
+#include "point.hpp"
+
+struct DynamicHullNode; // chain tree node, defined in dynamic_hull.cpp
+
+// Fully dynamic convex hull (Overmars-van Leeuwen). Each chain is a
+// weight-balanced leaf tree over x whose internal nodes store only the
+// bridge between their children's upper hulls; insert and remove cost
+// O(log^2 n) amortized, and points hidden under a removed vertex come
+// back without rescanning the input. Not thread-safe.
+class DynamicHull {
+public:
+    DynamicHull() = default;
+    explicit DynamicHull(const std::vector<Point>& points);
+
+    DynamicHull(const DynamicHull&) = delete;
+    DynamicHull& operator=(const DynamicHull&) = delete;
+
+    // Duplicates are kept; remove() takes out one copy and returns false
+    // if the point is not present
+    void insert(const Point& p);
+    bool remove(const Point& p);
+    void clear();
+    size_t size() const { return count; }
+
+    // Same contract as ConvexHull::getConvexHullPoints(); rebuilt in
+    // O(h log n) only after an update touched a chain
+    const std::vector<Point>& hull() const;
+    double area() const;
+
+private:
+    // Upper hull of one (x, y) per distinct x
+    class Chain {
+    public:
+        Chain() = default;
+        ~Chain();
+
+        Chain(const Chain&) = delete;
+        Chain& operator=(const Chain&) = delete;
+
+        void assign(float x, float y);
+        void erase(float x);
+        void clear();
+        void vertices(std::vector<Point>& out, bool negate) const;
+
+    private:
+        DynamicHullNode* root = nullptr;
+
+        void fixUp(DynamicHullNode* n);
+        DynamicHullNode* rebuild(DynamicHullNode* n);
+    };
+
+    Chain upper;
+    Chain lower;   // y negated
+    std::map<float, std::multiset<float>> columns;  // every point, by x
+    size_t count = 0;
+
+    mutable std::vector<Point> vertices;
+    mutable double cachedArea = 0.0;
+    mutable bool dirty = false;
+
+    void rebuild() const;
+};
+
+#endif
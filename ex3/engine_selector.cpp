@@ -0,0 +1,244 @@
+#include "engine_selector.hpp"
+#include "prefilter.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iterator>
+#include <mutex>
+#include <random>
+
+typedef ConvexHull::Algorithm Algorithm;
+
+const size_t EngineSelector::smallInput;
+const size_t EngineSelector::sampleSize;
+const size_t EngineSelector::profileSizes[2] = {1 << 12, 1 << 16};
+
+// Measured on a single-core x86 host with AVX2: the most frequent winner
+// of four calibrate(5) runs, ties broken by a best-of-7 timing
+static const EngineSelector::Profile builtinProfiles[] = {
+    {"circle", 1 << 12, {0.000, 0.9961}, {Algorithm::GrahamKeyed, false}, 0.18},
+    {"ring-50", 1 << 12, {0.437, 0.5176}, {Algorithm::GrahamKeyed, false}, 0.21},
+    {"ring-5", 1 << 12, {0.838, 0.0664}, {Algorithm::GrahamKeyed, true}, 0.12},
+    {"disk", 1 << 12, {0.870, 0.0293}, {Algorithm::GrahamKeyed, true}, 0.11},
+    {"square", 1 << 12, {0.963, 0.0166}, {Algorithm::Graham, true}, 0.06},
+    {"gaussian", 1 << 12, {0.979, 0.0088}, {Algorithm::MonotoneChain, true}, 0.06},
+    {"lines", 1 << 12, {0.252, 0.0059}, {Algorithm::MonotoneChain, false}, 0.21},
+    {"circle", 1 << 16, {0.000, 0.9990}, {Algorithm::MonotoneChain, false}, 4.21},
+    {"ring-50", 1 << 16, {0.479, 0.4814}, {Algorithm::MonotoneChain, false}, 4.20},
+    {"ring-5", 1 << 16, {0.851, 0.0537}, {Algorithm::MonotoneChain, true}, 1.86},
+    {"disk", 1 << 16, {0.882, 0.0312}, {Algorithm::MonotoneChain, true}, 1.62},
+    {"square", 1 << 16, {0.965, 0.0166}, {Algorithm::MonotoneChain, true}, 0.93},
+    {"gaussian", 1 << 16, {0.988, 0.0098}, {Algorithm::MonotoneChain, true}, 0.88},
+    {"lines", 1 << 16, {0.238, 0.0059}, {Algorithm::MonotoneChain, false}, 3.32},
+};
+
+static std::mutex tableMutex;
+
+static std::vector<EngineSelector::Profile>& table() {
+    static std::vector<EngineSelector::Profile> profiles(std::begin(builtinProfiles),
+                                                         std::end(builtinProfiles));
+    return profiles;
+}
+
+// Features of the sample, which is the hull's scratch
+static EngineSelector::Features featuresOf(std::vector<Point>& sample) {
+    std::vector<Point> kept;
+    size_t dropped = aklToussaintFilter(sample, kept);
+    ConvexHull hull;
+    hull.setAlgorithm(Algorithm::MonotoneChain);
+    hull.findConvexHull(kept.data(), kept.size());
+    EngineSelector::Features f;
+    f.interior = double(dropped) / sample.size();
+    f.hullShare = double(hull.getConvexHullPoints().size()) / sample.size();
+    return f;
+}
+
+EngineSelector::Features EngineSelector::sample(const Point* pts, size_t n) {
+    size_t s = n < sampleSize ? n : sampleSize;
+    std::vector<Point> picked;
+    picked.reserve(s);
+    for (size_t i = 0; i < s; ++i)
+        picked.push_back(pts[i * n / s]);
+    return featuresOf(picked);
+}
+
+EngineSelector::Features EngineSelector::sample(const PointSoA& pts) {
+    return sample(pts.xData(), pts.yData(), pts.size());
+}
+
+EngineSelector::Features EngineSelector::sample(const float* xs, const float* ys, size_t n) {
+    size_t s = n < sampleSize ? n : sampleSize;
+    std::vector<Point> picked;
+    picked.reserve(s);
+    for (size_t i = 0; i < s; ++i)
+        picked.emplace_back(xs[i * n / s], ys[i * n / s]);
+    return featuresOf(picked);
+}
+
+// Sizes are compared by ratio, and features only among the profiles of
+// the closest size
+static ConvexHull::Plan nearestPlan(const EngineSelector::Features& f, size_t n) {
+    std::lock_guard<std::mutex> lock(tableMutex);
+    const std::vector<EngineSelector::Profile>& profiles = table();
+    ConvexHull::Plan plan = {Algorithm::MonotoneChain, false};
+    double bestSize = 0.0, best = 0.0;
+    for (size_t i = 0; i < profiles.size(); ++i) {
+        double ds = std::fabs(std::log(double(n) / profiles[i].n));
+        double di = f.interior - profiles[i].features.interior;
+        double dh = f.hullShare - profiles[i].features.hullShare;
+        double d = di * di + dh * dh;
+        if (i == 0 || ds < bestSize || (ds == bestSize && d < best)) {
+            bestSize = ds;
+            best = d;
+            plan = profiles[i].plan;
+        }
+    }
+    return plan;
+}
+
+ConvexHull::Plan EngineSelector::choose(const Point* pts, size_t n) {
+    if (n < smallInput) {
+        ConvexHull::Plan plan = {Algorithm::MonotoneChain, false};
+        return plan;
+    }
+    return nearestPlan(sample(pts, n), n);
+}
+
+ConvexHull::Plan EngineSelector::choose(const PointSoA& pts) {
+    return choose(pts.xData(), pts.yData(), pts.size());
+}
+
+ConvexHull::Plan EngineSelector::choose(const float* xs, const float* ys, size_t n) {
+    if (n < smallInput) {
+        ConvexHull::Plan plan = {Algorithm::MonotoneChain, false};
+        return plan;
+    }
+    return nearestPlan(sample(xs, ys, n), n);
+}
+
+// Calibration inputs: a share of the points on a circle, the rest inside
+// it, down to a square and a gaussian blob; and the square's sides and
+// diagonal, where almost nothing is a vertex or filtered out
+static std::vector<Point> makeProfile(const char* name, size_t n) {
+    std::mt19937 rng(20240917);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const double pi = 3.14159265358979323846;
+    std::vector<Point> pts;
+    pts.reserve(n);
+    std::string kind(name);
+    if (kind == "square") {
+        for (size_t i = 0; i < n; ++i)
+            pts.emplace_back(2000.0 * unit(rng) - 1000.0, 2000.0 * unit(rng) - 1000.0);
+        return pts;
+    }
+    if (kind == "lines") {
+        std::uniform_int_distribution<int> line(0, 3);
+        for (size_t i = 0; i < n; ++i) {
+            double v = 2000.0 * unit(rng) - 1000.0;
+            switch (line(rng)) {
+                case 0: pts.emplace_back(v, -1000.0); break;
+                case 1: pts.emplace_back(1000.0, v); break;
+                case 2: pts.emplace_back(v, v); break;
+                default: pts.emplace_back(-1000.0, v); break;
+            }
+        }
+        return pts;
+    }
+    if (kind == "gaussian") {
+        std::normal_distribution<double> d(0.0, 100.0);
+        for (size_t i = 0; i < n; ++i)
+            pts.emplace_back(d(rng), d(rng));
+        return pts;
+    }
+    double onCircle = kind == "circle" ? 1.0 : kind == "ring-50" ? 0.5 : kind == "ring-5" ? 0.05 : 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double a = 2 * pi * unit(rng);
+        double r = unit(rng) < onCircle ? 1000.0 : 990.0 * std::sqrt(unit(rng));
+        pts.emplace_back(r * std::cos(a), r * std::sin(a));
+    }
+    return pts;
+}
+
+// The fastest plan on one calibration input
+static EngineSelector::Profile measure(const char* name, size_t n, int repeats) {
+    // Filtered inputs leave several plans within noise of each other; a
+    // later candidate has to be clearly faster to take over
+    static const Algorithm engines[] = {Algorithm::MonotoneChain, Algorithm::DivideAndConquer,
+                                        Algorithm::QuickHull, Algorithm::GrahamKeyed,
+                                        Algorithm::Graham};
+    const double margin = 0.95;
+    std::vector<Point> pts = makeProfile(name, n);
+    EngineSelector::Profile profile = {name, n, EngineSelector::sample(pts.data(), pts.size()),
+                                       {Algorithm::MonotoneChain, false}, 0.0};
+    bool first = true;
+    for (Algorithm engine : engines) {
+        for (int filter = 0; filter < 2; ++filter) {
+            // Engines reorder their input, so every run gets a fresh copy
+            double best = 0.0;
+            for (int r = 0; r < repeats; ++r) {
+                ConvexHull ch(pts);
+                ch.setAlgorithm(engine);
+                ch.setPrefilter(filter != 0);
+                auto start = std::chrono::steady_clock::now();
+                ch.findConvexHull();
+                auto end = std::chrono::steady_clock::now();
+                double ms = std::chrono::duration<double, std::milli>(end - start).count();
+                if (r == 0 || ms < best)
+                    best = ms;
+            }
+            if (first || best < profile.ms * margin) {
+                profile.plan.algorithm = engine;
+                profile.plan.prefilter = filter != 0;
+                profile.ms = best;
+                first = false;
+            }
+        }
+    }
+    return profile;
+}
+
+std::vector<EngineSelector::Profile> EngineSelector::calibrate(int repeats) {
+    static const char* const names[] = {"circle", "ring-50", "ring-5", "disk", "square", "gaussian",
+                                        "lines"};
+    std::vector<Profile> measured;
+    for (size_t n : profileSizes)
+        for (const char* name : names)
+            measured.push_back(measure(name, n, repeats));
+
+    std::lock_guard<std::mutex> lock(tableMutex);
+    table() = measured;
+    return measured;
+}
+
+std::vector<EngineSelector::Profile> EngineSelector::profiles() {
+    std::lock_guard<std::mutex> lock(tableMutex);
+    return table();
+}
+
+void EngineSelector::printProfiles(std::ostream& out) {
+    char line[128];
+    snprintf(line, sizeof(line), "%-10s %6s %9s %11s %-14s %10s\n", "profile", "n", "interior",
+             "hull share", "plan", "time (ms)");
+    out << line;
+    for (const Profile& p : profiles()) {
+        snprintf(line, sizeof(line), "%-10s %6zu %9.3f %11.4f %-14s %10.2f\n", p.name, p.n,
+                 p.features.interior, p.features.hullShare, planName(p.plan).c_str(), p.ms);
+        out << line;
+    }
+}
+
+const char* EngineSelector::algorithmName(Algorithm algorithm) {
+    switch (algorithm) {
+        case Algorithm::GrahamKeyed: return "graham-key";
+        case Algorithm::MonotoneChain: return "monotone";
+        case Algorithm::QuickHull: return "quickhull";
+        case Algorithm::DivideAndConquer: return "divide";
+        case Algorithm::Auto: return "auto";
+        case Algorithm::Graham:
+        default: return "graham";
+    }
+}
+
+std::string EngineSelector::planName(const ConvexHull::Plan& plan) {
+    return std::string(plan.prefilter ? "pf+" : "") + algorithmName(plan.algorithm);
+}
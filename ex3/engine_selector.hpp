@@ -0,0 +1,68 @@
+#ifndef ENGINE_SELECTOR_HPP
+#define ENGINE_SELECTOR_HPP
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "convex_hull.hpp"
+#include "point.hpp"
+#include "point_soa.hpp"
+
+// Picks the hull engine for an input behind ConvexHull::Algorithm::Auto.
+// A strided sample of the input gives two features: the share of it
+// strictly inside its own Akl-Toussaint octagon (about what the prefilter
+// would drop) and the share of it on its own hull (near 1 for circle-heavy
+// inputs, tiny for blobs). The plan is that of the nearest profile in a
+// table of measured inputs, among those measured at the size closest to
+// the input's: built in from one host, or measured on this one by
+// calibrate(). The candidates are ex3's engines with and without the
+// prefilter; ex3 has no Jarvis engine (that is ex1's ConvexJarvis).
+class EngineSelector {
+public:
+    struct Features {
+        double interior;
+        double hullShare;
+    };
+
+    // One measured input: its size and features, the fastest plan on it
+    // and that plan's time
+    struct Profile {
+        const char* name;
+        size_t n;
+        Features features;
+        ConvexHull::Plan plan;
+        double ms;
+    };
+
+    // Smaller inputs skip the sample and run the monotone chain: the
+    // sample would be half the input or more and cost about what the
+    // prefilter could save
+    static const size_t smallInput = 2048;
+    static const size_t sampleSize = 1024;
+
+    static Features sample(const Point* pts, size_t n);
+    static Features sample(const PointSoA& pts);
+    static Features sample(const float* xs, const float* ys, size_t n);
+
+    static ConvexHull::Plan choose(const Point* pts, size_t n);
+    static ConvexHull::Plan choose(const PointSoA& pts);
+    static ConvexHull::Plan choose(const float* xs, const float* ys, size_t n);
+
+    // Times every engine, with and without the prefilter, on synthetic
+    // inputs of each profileSizes[] size, from circles (h = n) to gaussian
+    // blobs and lines, and makes the winners the table choose() consults.
+    // Returns the new table.
+    static const size_t profileSizes[2];
+    static std::vector<Profile> calibrate(int repeats = 2);
+
+    // The table choose() consults, and it in readable form
+    static std::vector<Profile> profiles();
+    static void printProfiles(std::ostream& out);
+
+    // "monotone", "pf+quickhull", ... as in the benchmark tables
+    static const char* algorithmName(ConvexHull::Algorithm algorithm);
+    static std::string planName(const ConvexHull::Plan& plan);
+};
+
+#endif
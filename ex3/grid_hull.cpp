@@ -0,0 +1,221 @@
+#include "grid_hull.hpp"
+#include "hull_query.hpp"
+#include "simd_kernels.hpp"
+#include <algorithm>
+#include <cmath>
+
+const uint32_t GridHull::none;
+
+// Order-preserving (x, y) key: biased x in the high half, biased y low
+static uint64_t gridKey(int32_t x, int32_t y) {
+    return (uint64_t(uint32_t(x) ^ 0x80000000u) << 32) | (uint32_t(y) ^ 0x80000000u);
+}
+
+static GridPoint keyPoint(uint64_t key) {
+    GridPoint p;
+    p.x = int32_t(uint32_t(key >> 32) ^ 0x80000000u);
+    p.y = int32_t(uint32_t(key) ^ 0x80000000u);
+    return p;
+}
+
+bool GridHull::toGrid(double wx, double wy, GridPoint& out) const {
+    double gx = std::nearbyint(wx / scale), gy = std::nearbyint(wy / scale);
+    if (!(std::fabs(gx) <= gridLimit && std::fabs(gy) <= gridLimit))
+        return false; // out of range, or NaN
+    out.x = int32_t(gx);
+    out.y = int32_t(gy);
+    return true;
+}
+
+bool GridHull::addPoint(double wx, double wy) {
+    GridPoint p;
+    if (!toGrid(wx, wy, p)) return false;
+    addPoint(p);
+    return true;
+}
+
+size_t GridHull::KeyHash::operator()(uint64_t key) const {
+    uint64_t h = key * 0x9E3779B97F4A7C15ull;
+    h ^= h >> 31;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 29;
+    return size_t(h);
+}
+
+void GridHull::addPoint(const GridPoint& p) {
+    uint32_t i = uint32_t(xs.size());
+    xs.push_back(p.x);
+    ys.push_back(p.y);
+    auto slot = heads.emplace(gridKey(p.x, p.y), i);
+    next.push_back(slot.second ? none : slot.first->second);
+    slot.first->second = i;
+}
+
+// Order is not kept: the last point fills the hole
+bool GridHull::removePoint(const GridPoint& p) {
+    auto head = heads.find(gridKey(p.x, p.y));
+    if (head == heads.end()) return false;
+    uint32_t i = head->second;
+    if (next[i] == none)
+        heads.erase(head);
+    else
+        head->second = next[i];
+
+    uint32_t last = uint32_t(xs.size() - 1);
+    if (i != last) {
+        xs[i] = xs[last];
+        ys[i] = ys[last];
+        next[i] = next[last];
+        // Point whatever referred to the last point at its new slot
+        uint32_t* link = &heads.find(gridKey(xs[i], ys[i]))->second;
+        while (*link != last)
+            link = &next[*link];
+        *link = i;
+    }
+    xs.pop_back();
+    ys.pop_back();
+    next.pop_back();
+    return true;
+}
+
+bool GridHull::contains(const GridPoint& p) const {
+    return heads.count(gridKey(p.x, p.y)) != 0;
+}
+
+void GridHull::clear() {
+    xs.clear();
+    ys.clear();
+    heads.clear();
+    next.clear();
+    chGrid.clear();
+}
+
+int GridHull::orientation(const GridPoint& a, const GridPoint& b, const GridPoint& c) {
+    int64_t v = gridCross(a, b, c);
+    return (v > 0) - (v < 0);
+}
+
+// Keys of the points that can be hull vertices: the Akl-Toussaint stage
+// over the grid, dropping points strictly inside the extreme octagon
+void GridHull::candidates(ArenaVector<uint64_t>& keys) const {
+    size_t n = xs.size();
+    const int32_t* x = xs.data();
+    const int32_t* y = ys.data();
+    keys.clear();
+
+    // Counterclockwise: min x, min x+y, min y, max x-y, max x, max x+y, max y, min x-y
+    size_t idx[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    for (size_t i = 1; i < n; ++i) {
+        int64_t s = int64_t(x[i]) + y[i], d = int64_t(x[i]) - y[i];
+        if (x[i] < x[idx[0]]) idx[0] = i;
+        if (s < int64_t(x[idx[1]]) + y[idx[1]]) idx[1] = i;
+        if (y[i] < y[idx[2]]) idx[2] = i;
+        if (d > int64_t(x[idx[3]]) - y[idx[3]]) idx[3] = i;
+        if (x[i] > x[idx[4]]) idx[4] = i;
+        if (s > int64_t(x[idx[5]]) + y[idx[5]]) idx[5] = i;
+        if (y[i] > y[idx[6]]) idx[6] = i;
+        if (d < int64_t(x[idx[7]]) - y[idx[7]]) idx[7] = i;
+    }
+
+    size_t from[8], to[8];
+    int edges = 0;
+    for (int k = 0; k < 8; ++k) {
+        size_t a = idx[k], b = idx[(k + 1) % 8];
+        if (x[a] == x[b] && y[a] == y[b]) continue;
+        from[edges] = a;
+        to[edges] = b;
+        ++edges;
+    }
+    if (n < 9 || edges < 3) {
+        keys.reserve(n);
+        for (size_t i = 0; i < n; ++i)
+            keys.push_back(gridKey(x[i], y[i]));
+        return;
+    }
+
+    // Blocks small enough for the sign buffers to stay in L1
+    const size_t block = 1024;
+    int8_t sign[block];
+    uint8_t inside[block];
+    keys.reserve(n / 4);
+    for (size_t start = 0; start < n; start += block) {
+        size_t len = n - start < block ? n - start : block;
+        for (size_t j = 0; j < len; ++j)
+            inside[j] = 1;
+        for (int k = 0; k < edges; ++k) {
+            orientationBatchGrid(x[from[k]], y[from[k]], x[to[k]], y[to[k]],
+                                 x + start, y + start, len, sign);
+            for (size_t j = 0; j < len; ++j)
+                inside[j] &= sign[j] > 0;
+        }
+        for (size_t j = 0; j < len; ++j) {
+            if (!inside[j])
+                keys.push_back(gridKey(x[start + j], y[start + j]));
+        }
+    }
+}
+
+// Monotone chain over the surviving points sorted by (x, y); the keys and
+// the stack are arena scratch
+void GridHull::findConvexHull() {
+    chGrid.clear();
+    if (xs.size() < 3) return;
+
+    ArenaScope scope;
+    ArenaVector<uint64_t> keys;
+    candidates(keys);
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    size_t n = keys.size();
+    if (n < 3) return;
+
+    // Keep right turns only: upper chain left to right, then lower chain back
+    ArenaVector<GridPoint> hull;
+    for (size_t i = 0; i < n; ++i) {
+        GridPoint p = keyPoint(keys[i]);
+        while (hull.size() >= 2 && gridCross(hull[hull.size() - 2], hull.back(), p) >= 0)
+            hull.pop_back();
+        hull.push_back(p);
+    }
+    for (size_t i = n - 1, upper = hull.size() + 1; i-- > 0;) {
+        GridPoint p = keyPoint(keys[i]);
+        while (hull.size() >= upper && gridCross(hull[hull.size() - 2], hull.back(), p) >= 0)
+            hull.pop_back();
+        hull.push_back(p);
+    }
+    hull.pop_back(); // last point repeats the first
+    if (hull.size() < 3) return;
+
+    auto start = std::min_element(hull.begin(), hull.end(), [](const GridPoint& a, const GridPoint& b) {
+        if (a.y != b.y)
+            return a.y < b.y;
+        return a.x < b.x;
+    });
+    chGrid.assign(start, hull.end());
+    chGrid.insert(chGrid.end(), hull.begin(), start);
+}
+
+bool GridHull::hullContains(const GridPoint& p) const {
+    return ::hullContains(chGrid.data(), chGrid.size(), p, orientation);
+}
+
+bool GridHull::isHullVertex(const GridPoint& p) const {
+    return hullHasVertex(chGrid.data(), chGrid.size(), p, orientation);
+}
+
+std::vector<Point> GridHull::getConvexHullPoints() const {
+    std::vector<Point> out;
+    out.reserve(chGrid.size());
+    for (const auto& p : chGrid)
+        out.emplace_back(float(worldX(p)), float(worldY(p)));
+    return out;
+}
+
+// Fan from the first vertex: on a clockwise hull every term is negative,
+// and their sum, twice the area, is below 2^63
+double GridHull::polygonArea() const {
+    uint64_t twice = 0;
+    for (size_t i = 1; i + 1 < chGrid.size(); ++i)
+        twice += uint64_t(-gridCross(chGrid[0], chGrid[i], chGrid[i + 1]));
+    return double(twice) / 2.0 * scale * scale;
+}
@@ -0,0 +1,85 @@
+#ifndef GRID_HULL_HPP
+#define GRID_HULL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "arena.hpp"
+#include "point.hpp"
+
+// A point on the integer grid: world coordinates divided by the grid scale
+struct GridPoint {
+    int32_t x, y;
+
+    bool operator==(const GridPoint& other) const { return x == other.x && y == other.y; }
+};
+
+// Largest |coordinate| on the grid. Differences then fit in 32 bits and
+// cross products in 64, so every predicate is exact.
+const int32_t gridLimit = (1 << 30) - 1;
+
+// Twice the signed area of (a, b, c): positive when c is left of a->b
+inline int64_t gridCross(const GridPoint& a, const GridPoint& b, const GridPoint& c) {
+    return (int64_t(b.x) - a.x) * (int64_t(c.y) - a.y) - (int64_t(b.y) - a.y) * (int64_t(c.x) - a.x);
+}
+
+// Convex hull over quantized coordinates. Points are snapped to the grid
+// x = round(wx / scale) and stored as int32 SoA; orientation is exact in
+// int64 and the prefilter runs the integer SIMD kernels. Coordinates past
+// 2^24 keep full precision, unlike the float Point path.
+class GridHull {
+public:
+    explicit GridHull(double scale = 1.0) : scale(scale > 0.0 ? scale : 1.0) {}
+
+    double getScale() const { return scale; }
+
+    // Snaps (wx, wy) to the grid; false if it lands outside gridLimit
+    bool toGrid(double wx, double wy, GridPoint& out) const;
+    double worldX(const GridPoint& p) const { return p.x * scale; }
+    double worldY(const GridPoint& p) const { return p.y * scale; }
+
+    // Duplicates are kept; removePoint() takes out one copy. The points are
+    // hashed by grid position, so contains() and removePoint() are expected
+    // O(1); removal swaps the last point into the hole.
+    bool addPoint(double wx, double wy);
+    void addPoint(const GridPoint& p);
+    bool removePoint(const GridPoint& p);
+    bool contains(const GridPoint& p) const;
+    void clear();
+    size_t size() const { return xs.size(); }
+    GridPoint at(size_t i) const { return GridPoint{xs[i], ys[i]}; }
+
+    // Same chPoints contract as ConvexHull: clockwise from the lowest (then
+    // leftmost) vertex, no collinear vertices, empty below 3 vertices
+    void findConvexHull();
+    const std::vector<GridPoint>& getGridHull() const { return chGrid; }
+    std::vector<Point> getConvexHullPoints() const; // rounded to float
+
+    // O(log h) tests against the last findConvexHull(), exact in grid units
+    bool hullContains(const GridPoint& p) const;
+    bool isHullVertex(const GridPoint& p) const;
+
+    // Exact in grid units, then scaled
+    double polygonArea() const;
+
+    static int orientation(const GridPoint& a, const GridPoint& b, const GridPoint& c);
+
+private:
+    double scale;
+    std::vector<int32_t> xs;
+    std::vector<int32_t> ys;
+    std::vector<GridPoint> chGrid;
+    // Index of the last point added at each grid position, and from each
+    // point the previous one at the same position, or none
+    struct KeyHash {
+        size_t operator()(uint64_t key) const;
+    };
+    static const uint32_t none = ~uint32_t(0);
+    std::unordered_map<uint64_t, uint32_t, KeyHash> heads;
+    std::vector<uint32_t> next;
+
+    void candidates(ArenaVector<uint64_t>& keys) const;
+};
+
+#endif
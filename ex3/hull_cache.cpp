@@ -0,0 +1,67 @@
+#include "hull_cache.hpp"
+#include "hull_query.hpp"
+#include "predicates.hpp"
+#include <cstdio>
+
+HullCache::Snapshot HullCache::lookup(uint64_t version) {
+    if (validFor(version)) {
+        ++hits;
+        return current;
+    }
+    ++misses;
+    return Snapshot();
+}
+
+HullCache::Snapshot HullCache::store(uint64_t version, std::vector<std::pair<double, double>> hull,
+                                     double area) {
+    std::shared_ptr<HullSnapshot> s(new HullSnapshot);
+    s->version = version;
+    s->area = area;
+
+    char line[128];
+    snprintf(line, sizeof(line), "Convex Hull (%zu points):\n", hull.size());
+    s->reply = line;
+    for (const auto& p : hull) {
+        snprintf(line, sizeof(line), "(%.2f, %.2f)\n", p.first, p.second);
+        s->reply += line;
+    }
+    snprintf(line, sizeof(line), "Area: %.2f\n", area);
+    s->reply += line;
+
+    s->hull = std::move(hull);
+    current = s;
+    validAt = version;
+    return current;
+}
+
+HullCache::Snapshot HullCache::store(uint64_t version, const std::vector<Point>& hull, double area) {
+    std::vector<std::pair<double, double>> world;
+    world.reserve(hull.size());
+    for (const auto& p : hull)
+        world.emplace_back(p.getX(), p.getY());
+    return store(version, std::move(world), area);
+}
+
+typedef std::pair<double, double> WorldPoint;
+
+static int orientWorld(const WorldPoint& a, const WorldPoint& b, const WorldPoint& c) {
+    return orient2d(a.first, a.second, b.first, b.second, c.first, c.second);
+}
+
+bool HullCache::contains(uint64_t version, double x, double y) const {
+    return validFor(version) &&
+           hullContains(current->hull.data(), current->hull.size(), WorldPoint(x, y), orientWorld);
+}
+
+bool HullCache::isVertex(uint64_t version, double x, double y) const {
+    return validFor(version) &&
+           hullHasVertex(current->hull.data(), current->hull.size(), WorldPoint(x, y), orientWorld);
+}
+
+bool HullCache::carry(uint64_t from, uint64_t to) {
+    if (!validFor(from))
+        return false;
+    validAt = to;
+    ++avoidedRecomputes;
+    return true;
+}
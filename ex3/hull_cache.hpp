@@ -0,0 +1,64 @@
+#ifndef HULL_CACHE_HPP
+#define HULL_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "point.hpp"
+
+// One CH answer, immutable once built: hull vertices in world coordinates,
+// the area and the reply text sent to clients
+struct HullSnapshot {
+    uint64_t version; // graph version it was computed for
+    std::vector<std::pair<double, double>> hull;
+    double area;
+    std::string reply; // "Convex Hull (h points):\n(x, y)\n...Area: a\n"
+};
+
+// CH results per graph version. A server bumps its version on every
+// mutation; only the first CH after one rebuilds the snapshot, and the
+// rest are served by handing out the same one. Not thread-safe: call it
+// under the graph lock. Snapshots stay valid after it moves on.
+class HullCache {
+public:
+    typedef std::shared_ptr<const HullSnapshot> Snapshot;
+
+    // The snapshot for version, or null if the graph changed since
+    Snapshot lookup(uint64_t version);
+
+    // Formats the reply and makes the snapshot current
+    Snapshot store(uint64_t version, std::vector<std::pair<double, double>> hull, double area);
+    Snapshot store(uint64_t version, const std::vector<Point>& hull, double area);
+
+    // O(log h) tests against the snapshot valid at version: (x, y) inside
+    // the hull or on its boundary, or one of its vertices. Both are false
+    // when there is no such snapshot.
+    bool contains(uint64_t version, double x, double y) const;
+    bool isVertex(uint64_t version, double x, double y) const;
+
+    // After a change from version from to to that cannot alter the hull
+    // (adding a point it contains, removing points that are not vertices),
+    // the snapshot valid at from is served for to as well. False if there
+    // is none.
+    bool carry(uint64_t from, uint64_t to);
+
+    void clear() { current.reset(); }
+
+    uint64_t getHits() const { return hits; }
+    uint64_t getMisses() const { return misses; }
+    uint64_t getAvoidedRecomputes() const { return avoidedRecomputes; }
+
+private:
+    Snapshot current;
+    uint64_t validAt = 0; // graph version current answers for
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t avoidedRecomputes = 0;
+
+    bool validFor(uint64_t version) const { return current && validAt == version; }
+};
+
+#endif
@@ -0,0 +1,287 @@
+#ifndef HULL_CORE_HPP
+#define HULL_CORE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "arena.hpp"
+#include "point.hpp"
+#include "predicates.hpp"
+#include "radix_sort.hpp"
+
+// Header-only sequential hull engines, templated on the coordinate type
+// and on how coordinates are read from a point. Any struct can be hulled
+// in place (payload fields ride along), and every comparator inlines.
+
+// Coordinate access for PointT. The default reads public x and y members;
+// specialize it for types that hide them.
+template <typename PointT>
+struct PointAccess {
+    static auto x(const PointT& p) -> decltype(p.x) { return p.x; }
+    static auto y(const PointT& p) -> decltype(p.y) { return p.y; }
+};
+
+template <>
+struct PointAccess<Point> {
+    static float x(const Point& p) { return p.getX(); }
+    static float y(const Point& p) { return p.getY(); }
+};
+
+// A packKeys(x, y) key as a point: it encodes float coordinates exactly
+struct PackedXYAccess {
+    static float x(uint64_t key) { return keyFloat(uint32_t(key >> 32)); }
+    static float y(uint64_t key) { return keyFloat(uint32_t(key)); }
+};
+
+// The calling thread's scratch for the radix presort of monotone(), kept
+// between calls like ConvexHull's own sorter
+struct HullSortScratch {
+    RadixSorter sorter;
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> order;
+    std::vector<uint64_t> hull;
+};
+
+inline HullSortScratch& hullSortScratch() {
+    static thread_local HullSortScratch scratch;
+    return scratch;
+}
+
+// Exact orientation and a wider type for distance ties, per scalar
+template <typename Scalar>
+struct HullScalar;
+
+template <>
+struct HullScalar<float> {
+    typedef double Wide;
+    static int orientation(float ax, float ay, float bx, float by, float cx, float cy) {
+        return orient2d(ax, ay, bx, by, cx, cy);
+    }
+};
+
+template <>
+struct HullScalar<double> {
+    typedef double Wide;
+    static int orientation(double ax, double ay, double bx, double by, double cx, double cy) {
+        return orient2d(ax, ay, bx, by, cx, cy);
+    }
+};
+
+// |coordinates| up to 2^30 - 1 (gridLimit), so int64 never overflows
+template <>
+struct HullScalar<int32_t> {
+    typedef int64_t Wide;
+    static int orientation(int32_t ax, int32_t ay, int32_t bx, int32_t by, int32_t cx, int32_t cy) {
+        int64_t v = (int64_t(bx) - ax) * (int64_t(cy) - ay) - (int64_t(by) - ay) * (int64_t(cx) - ax);
+        return (v > 0) - (v < 0);
+    }
+};
+
+// Hulls follow the ConvexHull chPoints contract: clockwise from the lowest
+// (then leftmost) vertex, no collinear vertices, empty below 3 vertices.
+template <typename Scalar, typename PointT, typename Access = PointAccess<PointT>>
+class BasicConvexHull {
+public:
+    typedef typename HullScalar<Scalar>::Wide Wide;
+
+    static Scalar x(const PointT& p) { return Scalar(Access::x(p)); }
+    static Scalar y(const PointT& p) { return Scalar(Access::y(p)); }
+
+    // +1 counterclockwise, -1 clockwise, 0 collinear; exact
+    static int orientation(const PointT& a, const PointT& b, const PointT& c) {
+        return HullScalar<Scalar>::orientation(x(a), y(a), x(b), y(b), x(c), y(c));
+    }
+
+    static bool lessXY(const PointT& a, const PointT& b) {
+        if (x(a) != x(b))
+            return x(a) < x(b);
+        return y(a) < y(b);
+    }
+
+    static bool lessYX(const PointT& a, const PointT& b) {
+        if (y(a) != y(b))
+            return y(a) < y(b);
+        return x(a) < x(b);
+    }
+
+    static bool same(const PointT& a, const PointT& b) {
+        return x(a) == x(b) && y(a) == y(b);
+    }
+
+    // Monotone chain over points sorted by lessXY. Writes the clockwise
+    // hull starting at the leftmost point to out; unlike the contract it
+    // keeps degenerate results (one point, or the two ends of a collinear
+    // set). The stack lives in the thread's arena, so out's capacity is the
+    // only heap memory involved.
+    static void chain(const PointT* pts, size_t n, std::vector<PointT>& out) {
+        if (n < 3) {
+            out.assign(pts, pts + n);
+            if (n == 2 && same(out[0], out[1])) out.pop_back();
+            return;
+        }
+
+        // Keep right turns only: upper chain left to right, then lower chain back
+        ArenaScope scope;
+        ArenaVector<PointT> stack;
+        for (size_t i = 0; i < n; ++i) {
+            while (stack.size() >= 2 && orientation(stack[stack.size() - 2], stack.back(), pts[i]) >= 0)
+                stack.pop_back();
+            stack.push_back(pts[i]);
+        }
+        for (size_t i = n - 1, upper = stack.size() + 1; i-- > 0;) {
+            while (stack.size() >= upper && orientation(stack[stack.size() - 2], stack.back(), pts[i]) >= 0)
+                stack.pop_back();
+            stack.push_back(pts[i]);
+        }
+        out.assign(stack.begin(), stack.end() - 1); // last point repeats the first
+        if (out.size() == 2 && same(out[0], out[1])) out.pop_back(); // all points equal
+    }
+
+    static std::vector<PointT> chain(const PointT* pts, size_t n) {
+        std::vector<PointT> hull;
+        chain(pts, n, hull);
+        return hull;
+    }
+
+    // Rotates a clockwise hull to start at its pivot
+    static void rotateToPivot(std::vector<PointT>& hull) {
+        std::rotate(hull.begin(), std::min_element(hull.begin(), hull.end(), lessYX), hull.end());
+    }
+
+    // Andrew's monotone chain; may reorder [first, last). Large float inputs
+    // are radix sorted as packKeys(x, y) with their indices and the chain
+    // runs over the sorted keys, so the points are neither moved nor read
+    // again except for the hull vertices. Everything else is sorted by
+    // (x, y) in place, as a float key would merge distinct double or int32
+    // coordinates.
+    static void monotone(PointT* first, PointT* last, std::vector<PointT>& out) {
+        out.clear();
+        if (last - first < 3) return;
+        sortedChain(first, size_t(last - first), out,
+                    std::integral_constant<bool, std::is_same<Scalar, float>::value>());
+        if (out.size() < 3) {
+            out.clear();
+            return;
+        }
+        rotateToPivot(out);
+    }
+
+    // chain() over pts[order[0]], pts[order[1]], ... with order sorted by
+    // lessXY; the stack holds indices, so the points are never moved or
+    // copied, only the hull vertices written to out
+    static void chainIndexed(const PointT* pts, const uint32_t* order, size_t n,
+                             std::vector<PointT>& out) {
+        // The points are visited in sorted order, i.e. at random in memory
+        const size_t ahead = 16;
+        ArenaScope scope;
+        ArenaVector<uint32_t> stack;
+        for (size_t i = 0; i < n; ++i) {
+            if (i + ahead < n)
+                __builtin_prefetch(pts + order[i + ahead]);
+            const PointT& p = pts[order[i]];
+            while (stack.size() >= 2 &&
+                   orientation(pts[stack[stack.size() - 2]], pts[stack.back()], p) >= 0)
+                stack.pop_back();
+            stack.push_back(order[i]);
+        }
+        for (size_t i = n - 1, upper = stack.size() + 1; n > 2 && i-- > 0;) {
+            if (i >= ahead)
+                __builtin_prefetch(pts + order[i - ahead]);
+            const PointT& p = pts[order[i]];
+            while (stack.size() >= upper &&
+                   orientation(pts[stack[stack.size() - 2]], pts[stack.back()], p) >= 0)
+                stack.pop_back();
+            stack.push_back(order[i]);
+        }
+        if (n > 2)
+            stack.pop_back(); // last point repeats the first
+
+        out.clear();
+        for (size_t i = 0; i < stack.size(); ++i)
+            out.push_back(pts[stack[i]]);
+        if (out.size() == 2 && same(out[0], out[1])) out.pop_back(); // all points equal
+    }
+
+    static void sortedChain(PointT* pts, size_t n, std::vector<PointT>& out, std::false_type) {
+        std::sort(pts, pts + n, lessXY);
+        chain(pts, n, out);
+    }
+
+    static void sortedChain(PointT* pts, size_t n, std::vector<PointT>& out, std::true_type) {
+        if (n < RadixSorter::smallInput) {
+            sortedChain(pts, n, out, std::false_type());
+            return;
+        }
+        HullSortScratch& s = hullSortScratch();
+        s.keys.resize(n);
+        for (size_t i = 0; i < n; ++i)
+            s.keys[i] = packKeys(x(pts[i]), y(pts[i]));
+        s.sorter.sortIndexByKey(s.keys.data(), n, s.order);
+        BasicConvexHull<float, uint64_t, PackedXYAccess>::chain(s.keys.data(), n, s.hull);
+        // Each vertex back to a point with its key; copies are interchangeable
+        out.clear();
+        for (uint64_t key : s.hull) {
+            size_t at = std::lower_bound(s.keys.begin(), s.keys.end(), key) - s.keys.begin();
+            out.push_back(pts[s.order[at]]);
+        }
+    }
+
+    static Wide manhattan(const PointT& p0, const PointT& p) {
+        Wide dx = Wide(x(p)) - Wide(x(p0)), dy = Wide(y(p)) - Wide(y(p0));
+        return (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
+    }
+
+    // Graham order around the pivot p0: clockwise by angle, and along a ray
+    // nearest first, by Manhattan distance in Wide
+    static bool lessAngle(const PointT& p0, const PointT& a, const PointT& b) {
+        int o = orientation(p0, a, b);
+        if (o == 0)
+            return manhattan(p0, a) < manhattan(p0, b);
+        return o < 0;
+    }
+
+    // Graham scan; sorts [first, last) by lessAngle around the pivot in place
+    static void graham(PointT* first, PointT* last, std::vector<PointT>& out) {
+        out.clear();
+        if (last - first < 3) return;
+
+        PointT p0 = *std::min_element(first, last, lessYX);
+        std::sort(first, last, [&](const PointT& a, const PointT& b) { return lessAngle(p0, a, b); });
+
+        ArenaScope scope;
+        ArenaVector<PointT> stack;
+        for (PointT* p = first; p != last; ++p) {
+            while (stack.size() > 1 && orientation(stack[stack.size() - 2], stack.back(), *p) >= 0)
+                stack.pop_back();
+            stack.push_back(*p);
+        }
+        if (stack.size() >= 3)
+            out.assign(stack.begin(), stack.end());
+    }
+
+    // The Graham stack pass over pts[order[0]], pts[order[1]], ... with
+    // order sorted by lessAngle; the stack holds indices
+    static void grahamIndexed(const PointT* pts, const uint32_t* order, size_t n,
+                              std::vector<PointT>& out) {
+        out.clear();
+        if (n < 3) return;
+
+        ArenaScope scope;
+        ArenaVector<uint32_t> stack;
+        for (size_t i = 0; i < n; ++i) {
+            const PointT& p = pts[order[i]];
+            while (stack.size() > 1 &&
+                   orientation(pts[stack[stack.size() - 2]], pts[stack.back()], p) >= 0)
+                stack.pop_back();
+            stack.push_back(order[i]);
+        }
+        if (stack.size() >= 3) {
+            for (size_t i = 0; i < stack.size(); ++i)
+                out.push_back(pts[stack[i]]);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef HULL_QUERY_HPP
+#define HULL_QUERY_HPP
+
+#include <cstddef>
+
+// O(log h) point queries against a hull under the chPoints contract:
+// clockwise from the lowest (then leftmost) vertex, no collinear vertices,
+// at least 3 vertices. Orient is an exact orientation predicate on P
+// (+1 counterclockwise, -1 clockwise, 0 collinear).
+
+// Seen from hull[0] the other vertices run clockwise over less than half a
+// turn, so the rays hull[0]->hull[i] cut that cone into wedges. Returns the
+// last i in [1, h) with q clockwise from or on its ray; q must lie in the
+// cone.
+template <typename P, typename Orient>
+size_t hullWedge(const P* hull, size_t h, const P& q, Orient orient) {
+    size_t lo = 1, hi = h;
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (orient(hull[0], hull[mid], q) <= 0)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// q in that cone, boundary rays included
+template <typename P, typename Orient>
+bool hullCone(const P* hull, size_t h, const P& q, Orient orient) {
+    return orient(hull[0], hull[1], q) <= 0 && orient(hull[0], hull[h - 1], q) >= 0;
+}
+
+// q inside the hull or on its boundary, so adding it keeps the hull
+template <typename P, typename Orient>
+bool hullContains(const P* hull, size_t h, const P& q, Orient orient) {
+    if (h < 3 || !hullCone(hull, h, q, orient))
+        return false;
+    size_t k = hullWedge(hull, h, q, orient);
+    if (k == h - 1)
+        k = h - 2;
+    return orient(hull[k], hull[k + 1], q) <= 0;
+}
+
+// q is one of the hull's vertices, so removing it may change the hull
+template <typename P, typename Orient>
+bool hullHasVertex(const P* hull, size_t h, const P& q, Orient orient) {
+    if (h < 3)
+        return false;
+    if (hull[0] == q)
+        return true;
+    if (!hullCone(hull, h, q, orient))
+        return false;
+    return hull[hullWedge(hull, h, q, orient)] == q;
+}
+
+#endif
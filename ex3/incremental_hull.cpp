@@ -0,0 +1,102 @@
+#include "incremental_hull.hpp"
+#include "point_soa.hpp"
+#include "predicates.hpp"
+#include "simd_kernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+IncrementalHull::IncrementalHull(const std::vector<Point>& points) {
+    for (const auto& p : points)
+        insert(p);
+}
+
+bool IncrementalHull::insert(const Point& p) {
+    bool changed = insertChain(upper, p.getX(), p.getY());
+    changed = insertChain(lower, p.getX(), -p.getY()) || changed;
+    if (changed)
+        dirty = true;
+    return changed;
+}
+
+void IncrementalHull::clear() {
+    upper.clear();
+    lower.clear();
+    vertices.clear();
+    cachedArea = 0.0;
+    dirty = false;
+}
+
+// Adds (x, y) to the chain if it lies strictly above it, then drops the
+// neighbours on either side that are no longer strictly convex. With a
+// left of b, orient2d(a, b, c) > 0 means c is above the line a->b.
+bool IncrementalHull::insertChain(Chain& chain, float x, float y) {
+    auto it = chain.lower_bound(x);
+    if (it != chain.end() && it->first == x) {
+        if (it->second >= y) return false;
+        it = chain.erase(it);
+    } else if (it != chain.end() && it != chain.begin()) {
+        auto prev = std::prev(it);
+        if (orient2d(prev->first, prev->second, it->first, it->second, x, y) <= 0)
+            return false;
+    }
+    it = chain.emplace_hint(it, x, y);
+
+    for (auto next = std::next(it); next != chain.end();) {
+        auto after = std::next(next);
+        if (after == chain.end() ||
+            orient2d(x, y, after->first, after->second, next->first, next->second) > 0)
+            break;
+        chain.erase(next);
+        next = after;
+    }
+    while (it != chain.begin()) {
+        auto prev = std::prev(it);
+        if (prev == chain.begin()) break;
+        auto before = std::prev(prev);
+        if (orient2d(before->first, before->second, x, y, prev->first, prev->second) > 0)
+            break;
+        chain.erase(prev);
+    }
+    return true;
+}
+
+const std::vector<Point>& IncrementalHull::hull() const {
+    if (dirty)
+        rebuild();
+    return vertices;
+}
+
+double IncrementalHull::area() const {
+    if (dirty)
+        rebuild();
+    return cachedArea;
+}
+
+// Upper chain left to right, then the lower chain back, sharing endpoints
+void IncrementalHull::rebuild() const {
+    dirty = false;
+    vertices.clear();
+    cachedArea = 0.0;
+    for (const auto& e : upper)
+        vertices.emplace_back(e.first, e.second);
+    for (auto it = lower.rbegin(); it != lower.rend(); ++it) {
+        Point q(it->first, -it->second);
+        if (!(q == vertices.back()) && !(q == vertices.front()))
+            vertices.push_back(q);
+    }
+    if (vertices.size() < 3) {
+        vertices.clear();
+        return;
+    }
+
+    auto start = std::min_element(vertices.begin(), vertices.end(), [](const Point& a, const Point& b) {
+        if (a.getY() != b.getY())
+            return a.getY() < b.getY();
+        return a.getX() < b.getX();
+    });
+    std::rotate(vertices.begin(), start, vertices.end());
+
+    PointSoA soa(vertices);
+    cachedArea = std::abs(shoelaceSum(soa.xData(), soa.yData(), soa.size())) / 2.0;
+}
@@ -0,0 +1,43 @@
+#ifndef INCREMENTAL_HULL_HPP
+#define INCREMENTAL_HULL_HPP
+
+#include <cstddef>
+#include <map>
+#include <vector>
+#include "point.hpp"
+
+// Online convex hull for insert-only streams. The upper and lower chains
+// live in balanced search trees keyed by x, so an insertion costs
+// O(log n) amortized and interior points are dropped on arrival. Not
+// thread-safe; callers serialize access.
+class IncrementalHull {
+public:
+    IncrementalHull() = default;
+    explicit IncrementalHull(const std::vector<Point>& points);
+
+    // Returns true if the hull changed
+    bool insert(const Point& p);
+    void clear();
+
+    // Same contract as ConvexHull::getConvexHullPoints(): clockwise from the
+    // lowest (then leftmost) vertex, no collinear vertices, empty below 3.
+    // Rebuilt in O(h) only after the hull changed.
+    const std::vector<Point>& hull() const;
+    double area() const;
+
+private:
+    // y of the chain vertex at each x, strictly convex left to right
+    typedef std::map<float, float> Chain;
+
+    Chain upper;
+    Chain lower;   // y negated, so both chains keep right turns only
+
+    mutable std::vector<Point> vertices;
+    mutable double cachedArea = 0.0;
+    mutable bool dirty = false;
+
+    static bool insertChain(Chain& chain, float x, float y);
+    void rebuild() const;
+};
+
+#endif
@@ -1,13 +1,141 @@
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <ostream>
 #include <string>
 #include <sstream>
 #include "convex_hull.hpp"
+#include "engine_selector.hpp"
+#include "line_reader.hpp"
 #include "point.hpp"
 
-int main() {
+static void appendf(std::string& out, const char* format, ...) {
+    char text[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (len > 0)
+        out.append(text, std::min(size_t(len), sizeof(text) - 1));
+}
+
+static bool isWord(const char* word, const char* wordEnd, const char* expected) {
+    return size_t(wordEnd - word) == strlen(expected) && memcmp(word, expected, wordEnd - word) == 0;
+}
+
+// Batch mode: the same commands, read in large blocks and parsed with
+// std::from_chars. Nothing is prompted or echoed per point; CH results
+// and errors are collected and written out in one go at the end.
+static int runBatch(ConvexHull& ch, std::FILE* in) {
+    LineReader lines(in);
+    std::vector<Point> points;
+    std::string out;
+    const char* line;
+    const char* end;
+    while (lines.next(line, end)) {
+        const char* cmd;
+        const char* cmdEnd;
+        if (!scanWord(line, end, cmd, cmdEnd))
+            continue;
+
+        if (isWord(cmd, cmdEnd, "Newgraph")) {
+            long n = 0;
+            if (!scanLong(line, end, n) || n < 3) {
+                appendf(out, "At least 3 points are required to form a convex hull.\n");
+                continue;
+            }
+            points.clear();
+            // n is untrusted input; past the cap the vector grows
+            points.reserve(size_t(std::min<long>(n, 1 << 20)));
+            while (points.size() < size_t(n) && lines.next(line, end)) {
+                float x, y;
+                if (!scanFloat(line, end, x) || !scanFloat(line, end, y))
+                    break;
+                points.emplace_back(x, y);
+            }
+            if (points.size() == size_t(n))
+                ch.setGraph(points);
+            else
+                appendf(out, "Failed to create graph. Only %zu points were read instead of %ld.\n",
+                        points.size(), n);
+
+        } else if (isWord(cmd, cmdEnd, "CH")) {
+            ch.updateConvexHull();
+            const std::vector<Point>& hull = ch.getConvexHullPoints();
+            if (hull.empty()) {
+                appendf(out, "No convex hull found (need at least 3 points)\n");
+                continue;
+            }
+            appendf(out, "Convex Hull:\n");
+            for (const auto& p : hull)
+                appendf(out, "(%g, %g)\n", p.getX(), p.getY());
+            appendf(out, "Area: %g\n", ch.polygonArea());
+
+        } else if (isWord(cmd, cmdEnd, "Newpoint") || isWord(cmd, cmdEnd, "Removepoint")) {
+            bool adding = isWord(cmd, cmdEnd, "Newpoint");
+            float x, y;
+            if (!scanFloat(line, end, x) || !scanFloat(line, end, y)) {
+                appendf(out, "Invalid format. Use: %s x y\n", adding ? "Newpoint" : "Removepoint");
+                continue;
+            }
+            if (adding)
+                ch.addPoint(Point(x, y));
+            else
+                ch.removePoint(Point(x, y));
+
+        } else if (isWord(cmd, cmdEnd, "Exit")) {
+            break;
+        } else {
+            appendf(out, "Unknown command. Available commands: Newgraph, CH, Newpoint, Removepoint\n");
+        }
+    }
+
+    bool readOk = !lines.failed();
+    if (!readOk)
+        appendf(out, "Read error\n");
+    std::fwrite(out.data(), 1, out.size(), stdout);
+    std::fflush(stdout);
+    return readOk ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
     std::vector<Point> points;
     ConvexHull ch(points);
+
+    // --batch [file|-] runs the commands non-interactively from the file
+    // (stdin by default)
+    bool calibrate = false;
+    const char* batchPath = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--calibrate")
+            calibrate = true;
+        else if (arg == "--batch")
+            batchPath = i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0 ? argv[++i] : "-";
+    }
+
+    // Engine picked per graph from a sample; --calibrate first measures
+    // the crossovers between engines on this host
+    ch.setAlgorithm(ConvexHull::Algorithm::Auto);
+    if (calibrate) {
+        std::cout << "Calibrating hull engines..." << std::endl;
+        EngineSelector::calibrate();
+        EngineSelector::printProfiles(std::cout);
+    }
+
+    if (batchPath != nullptr) {
+        std::FILE* in = strcmp(batchPath, "-") == 0 ? stdin : std::fopen(batchPath, "rb");
+        if (in == nullptr) {
+            perror(batchPath);
+            return 1;
+        }
+        int status = runBatch(ch, in);
+        if (in != stdin)
+            std::fclose(in);
+        return status;
+    }
     std::string command;
     
     std::cout << "=== Interactive Convex Hull Calculator ===" << std::endl;
@@ -57,15 +185,15 @@ int main() {
             
             if (points.size() == static_cast<size_t>(n)) {
                 ch.setGraph(points);
-                ch.findConvexHull();
                 std::cout << "Graph created successfully with " << n << " points!" << std::endl;
             } else {
                 std::cout << "Failed to create graph. Only " << points.size() << " points were read instead of " << n << "." << std::endl;
             }
             
         } else if (cmd == "CH") {
+            // Recomputed only if the graph changed since the last CH
             std::cout << "Calculating convex hull..." << std::endl;
-            ch.findConvexHull();
+            ch.updateConvexHull();
             ch.printConvexHull();
             
         } else if (cmd == "Newpoint") {
@@ -73,7 +201,6 @@ int main() {
             iss >> x >> y;
             Point newPoint(x, y);
             ch.addPoint(newPoint);
-            ch.findConvexHull();
             std::cout << "Point (" << x << ", " << y << ") added successfully!" << std::endl;
             
         } else if (cmd == "Removepoint") {
@@ -81,7 +208,6 @@ int main() {
             iss >> x >> y;
             Point pointToRemove(x, y);
             ch.removePoint(pointToRemove);
-            ch.findConvexHull();
             std::cout << "Point (" << x << ", " << y << ") removed successfully!" << std::endl;
             
         } else if (cmd == "Exit") {
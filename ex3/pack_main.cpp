@@ -0,0 +1,46 @@
+// Converts a text point file ("x y" per line) to the binary point file
+// format of point_file.hpp, which Loadgraph maps
+// Usage: ./convex_hull_pack <text file|-> <point file>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "point_file.hpp"
+#include "point_soa.hpp"
+#include "stream_hull.hpp"
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <text file|-> <point file>\n", argv[0]);
+        return 1;
+    }
+
+    std::FILE* in = strcmp(argv[1], "-") == 0 ? stdin : std::fopen(argv[1], "rb");
+    if (in == nullptr) {
+        perror(argv[1]);
+        return 1;
+    }
+    TextPointSource source(in);
+    PointSoA points;
+    std::vector<Point> chunk;
+    chunk.resize(1 << 16);
+    for (size_t n; (n = source.read(chunk.data(), chunk.size())) > 0;) {
+        for (size_t i = 0; i < n; ++i)
+            points.push_back(chunk[i]);
+    }
+    bool readOk = !source.failed();
+    if (in != stdin)
+        std::fclose(in);
+    if (!readOk) {
+        fprintf(stderr, "%s: read error\n", argv[1]);
+        return 1;
+    }
+
+    std::string error;
+    if (!PointFile::write(argv[2], points.xData(), points.yData(), points.size(), &error)) {
+        fprintf(stderr, "%s: %s\n", argv[2], error.c_str());
+        return 1;
+    }
+    fprintf(stderr, "Wrote %zu points to %s\n", points.size(), argv[2]);
+    return 0;
+}
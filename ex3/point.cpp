@@ -3,15 +3,6 @@
 // Constructor
 Point::Point(float x, float y) : x(x), y(y) {}
 
-// Getters
-float Point::getX() const { 
-    return x; 
-}
-
-float Point::getY() const { 
-    return y; 
-}
-
 // Setters
 void Point::setX(float newX) { 
     x = newX; 
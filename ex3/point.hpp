@@ -13,9 +13,9 @@ public:
     // Constructor
     Point(float x = 0.0f, float y = 0.0f);
     
-    // Getters
-    float getX() const;
-    float getY() const;
+    // Getters, inline so hot comparators need no call
+    float getX() const { return x; }
+    float getY() const { return y; }
     
     // Setters
     void setX(float newX);
@@ -0,0 +1,175 @@
+#include "point_file.hpp"
+#include "simd_kernels.hpp"
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(sizeof(PointFileHeader) == 64, "point file header must stay 64 bytes");
+
+const uint32_t PointFile::version;
+
+static const char pointFileMagic[8] = {'C', 'H', 'P', 'O', 'I', 'N', 'T', 'S'};
+static const uint64_t arrayAlignment = 64;
+
+static uint64_t alignUp(uint64_t v) {
+    return (v + arrayAlignment - 1) & ~(arrayAlignment - 1);
+}
+
+bool PointFile::fail(const std::string& reason) {
+    close();
+    message = reason;
+    return false;
+}
+
+bool PointFile::open(const char* path) {
+    close();
+    message.clear();
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        return fail(strerror(errno));
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        int err = errno;
+        ::close(fd);
+        return fail(strerror(err));
+    }
+    if (!S_ISREG(st.st_mode)) {
+        ::close(fd);
+        return fail("not a regular file");
+    }
+    if (size_t(st.st_size) < sizeof(PointFileHeader)) {
+        ::close(fd);
+        return fail("too short for a point file");
+    }
+
+    void* mapped = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    int err = errno;
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+        return fail(strerror(err));
+    base = mapped;
+    mappedBytes = size_t(st.st_size);
+    // Both arrays are read front to back by the hull engines
+    madvise(base, mappedBytes, MADV_SEQUENTIAL);
+
+    const PointFileHeader& h = header();
+    if (memcmp(h.magic, pointFileMagic, sizeof(pointFileMagic)) != 0)
+        return fail("not a point file");
+    if (h.version != version)
+        return fail("unsupported point file version " + std::to_string(h.version));
+    if (h.coordType != Float32)
+        return fail("unsupported coordinate type " + std::to_string(h.coordType));
+
+    // Offsets and count are checked separately so the products cannot wrap
+    uint64_t bytes = h.count * sizeof(float);
+    if (h.count > mappedBytes / sizeof(float) || h.xOffset % arrayAlignment != 0 ||
+        h.yOffset % arrayAlignment != 0 || h.xOffset > mappedBytes || h.yOffset > mappedBytes ||
+        bytes > mappedBytes - h.xOffset || bytes > mappedBytes - h.yOffset)
+        return fail("point arrays run past the end of the file");
+
+    count = size_t(h.count);
+    xs = reinterpret_cast<const float*>(static_cast<const char*>(base) + h.xOffset);
+    ys = reinterpret_cast<const float*>(static_cast<const char*>(base) + h.yOffset);
+    return true;
+}
+
+void PointFile::close() {
+    if (base != nullptr)
+        munmap(base, mappedBytes);
+    base = nullptr;
+    mappedBytes = 0;
+    count = 0;
+    xs = ys = nullptr;
+}
+
+static bool writePadded(std::FILE* out, const void* data, size_t bytes, uint64_t paddedTo) {
+    static const char zeros[arrayAlignment] = {};
+    if (bytes > 0 && std::fwrite(data, 1, bytes, out) != bytes)
+        return false;
+    size_t pad = size_t(paddedTo - bytes);
+    return pad == 0 || std::fwrite(zeros, 1, pad, out) == pad;
+}
+
+bool PointFile::write(const char* path, const float* xs, const float* ys, size_t n,
+                      std::string* error) {
+    PointFileHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, pointFileMagic, sizeof(pointFileMagic));
+    h.version = version;
+    h.coordType = Float32;
+    h.count = n;
+    if (n > 0) {
+        size_t idx[8];
+        extremePoints(xs, ys, n, idx);
+        h.minX = xs[idx[0]];
+        h.minY = ys[idx[2]];
+        h.maxX = xs[idx[4]];
+        h.maxY = ys[idx[6]];
+    }
+    uint64_t bytes = uint64_t(n) * sizeof(float);
+    h.xOffset = sizeof(PointFileHeader);
+    h.yOffset = alignUp(h.xOffset + bytes);
+
+    std::FILE* out = std::fopen(path, "wb");
+    if (out == nullptr) {
+        if (error != nullptr) *error = strerror(errno);
+        return false;
+    }
+    bool ok = writePadded(out, &h, sizeof(h), h.xOffset) &&
+              writePadded(out, xs, size_t(bytes), h.yOffset - h.xOffset) &&
+              writePadded(out, ys, size_t(bytes), bytes);
+    ok = std::fclose(out) == 0 && ok;
+    if (!ok && error != nullptr)
+        *error = strerror(errno);
+    return ok;
+}
+
+// realpath() into a std::string
+static bool canonicalPath(const std::string& in, std::string& out) {
+    char resolved[PATH_MAX];
+    if (realpath(in.c_str(), resolved) == nullptr)
+        return false;
+    out = resolved;
+    return true;
+}
+
+bool resolvePointFilePath(const std::string& dataDir, const std::string& name, std::string& path,
+                          std::string& error) {
+    if (dataDir.empty()) {
+        error = "no data directory, start the server with --data-dir";
+        return false;
+    }
+    if (name.empty() || name[0] == '/') {
+        error = "path must be relative to the data directory";
+        return false;
+    }
+    for (size_t begin = 0; begin <= name.size();) {
+        size_t end = name.find('/', begin);
+        if (end == std::string::npos) end = name.size();
+        if (name.compare(begin, end - begin, "..") == 0) {
+            error = "path may not contain ..";
+            return false;
+        }
+        begin = end + 1;
+    }
+
+    std::string root;
+    if (!canonicalPath(dataDir, root) || !canonicalPath(dataDir + "/" + name, path)) {
+        error = strerror(errno);
+        return false;
+    }
+    // A symlink inside the directory may still point out of it
+    bool inside = root == "/" || path == root ||
+                  (path.compare(0, root.size(), root) == 0 && path[root.size()] == '/');
+    if (!inside) {
+        error = "path leaves the data directory";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,67 @@
+#ifndef POINT_FILE_HPP
+#define POINT_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Binary point file: a 64-byte header, then the x and y coordinates as
+// two arrays, each starting on a 64-byte boundary. Everything is in host
+// byte order. A file is mapped rather than read, so loading it costs no
+// parsing and the arrays are used where they lie in the page cache.
+struct PointFileHeader {
+    char magic[8];      // "CHPOINTS"
+    uint32_t version;   // PointFile::version
+    uint32_t coordType; // PointFile::CoordType
+    uint64_t count;
+    float minX, minY, maxX, maxY; // bounds of the points, 0 if there are none
+    uint64_t xOffset;   // from the start of the file
+    uint64_t yOffset;
+    uint8_t reserved[8];
+};
+
+// Read-only mapping of a point file
+class PointFile {
+public:
+    static const uint32_t version = 1;
+    enum CoordType : uint32_t { Float32 = 1 };
+
+    PointFile() {}
+    ~PointFile() { close(); }
+    PointFile(const PointFile&) = delete;
+    PointFile& operator=(const PointFile&) = delete;
+
+    // Maps path and checks its header and size; false, with a reason in
+    // error(), if it is not a point file this build can read
+    bool open(const char* path);
+    void close();
+
+    // Writes n points as a point file, bounds included
+    static bool write(const char* path, const float* xs, const float* ys, size_t n,
+                      std::string* error = nullptr);
+
+    const PointFileHeader& header() const { return *reinterpret_cast<const PointFileHeader*>(base); }
+    size_t size() const { return count; }
+    const float* xData() const { return xs; }
+    const float* yData() const { return ys; }
+    const std::string& error() const { return message; }
+
+private:
+    void* base = nullptr;
+    size_t mappedBytes = 0;
+    size_t count = 0;
+    const float* xs = nullptr;
+    const float* ys = nullptr;
+    std::string message;
+
+    bool fail(const std::string& reason);
+};
+
+// Where a point file named by a client lives: name is taken relative to
+// dataDir and may not be absolute or contain ".." components, and the
+// result, symlinks resolved, must still be inside dataDir. False, with a
+// reason in error, otherwise or if the file does not exist.
+bool resolvePointFilePath(const std::string& dataDir, const std::string& name, std::string& path,
+                          std::string& error);
+
+#endif
@@ -0,0 +1,152 @@
+#include "point_index.hpp"
+#include <cmath>
+
+const size_t PointIndex::npos;
+const size_t PointIndex::maxSize;
+const uint32_t PointIndex::none;
+
+// A hair wider than the tolerance, so rounding in cellOf() cannot put a
+// match two cells away
+PointIndex::PointIndex(float tolerance)
+    : tolerance(tolerance), inverseCell(1.0 / (double(tolerance) * (1.0 + 1.0 / (1 << 20)))) {}
+
+// Cell coordinates are clamped well inside int64, so neighbours never
+// overflow; NaN lands in a corner cell and never matches anything
+static int64_t cellCoordinate(double v) {
+    const double limit = 4611686018427387904.0; // 2^62
+    if (!(v > -limit)) return -(int64_t(1) << 62);
+    if (v >= limit) return int64_t(1) << 62;
+    return int64_t(std::floor(v));
+}
+
+PointIndex::Cell PointIndex::cellOf(float x, float y) const {
+    Cell c = {cellCoordinate(x * inverseCell), cellCoordinate(y * inverseCell)};
+    return c;
+}
+
+size_t PointIndex::CellHash::operator()(const Cell& c) const {
+    uint64_t h = uint64_t(c.x) * 0x9E3779B97F4A7C15ull ^ uint64_t(c.y);
+    h ^= h >> 31;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 29;
+    return size_t(h);
+}
+
+// Same test the servers used on the plain vector
+bool PointIndex::matches(const Point& p, float x, float y) const {
+    return std::abs(p.getX() - x) < tolerance && std::abs(p.getY() - y) < tolerance;
+}
+
+size_t PointIndex::findNear(float x, float y) const {
+    if (gridStale) buildGrid();
+    Cell c = cellOf(x, y);
+    for (int64_t dx = -1; dx <= 1; ++dx) {
+        for (int64_t dy = -1; dy <= 1; ++dy) {
+            Cell n = {c.x + dx, c.y + dy};
+            auto head = heads.find(n);
+            if (head == heads.end()) continue;
+            for (uint32_t i = head->second; i != none; i = next[i]) {
+                if (matches(points[i], x, y))
+                    return i;
+            }
+        }
+    }
+    return npos;
+}
+
+// Puts point i, the last one the grid covers, at the head of its cell
+void PointIndex::link(uint32_t i) const {
+    auto head = heads.emplace(cellOf(points[i].getX(), points[i].getY()), i);
+    if (head.second) {
+        next.push_back(none);
+    } else {
+        next.push_back(head.first->second);
+        head.first->second = i;
+    }
+}
+
+void PointIndex::buildGrid() const {
+    next.clear();
+    heads.clear();
+    next.reserve(points.size());
+    heads.reserve(points.size());
+    for (size_t i = 0; i < points.size(); ++i)
+        link(uint32_t(i));
+    gridStale = false;
+}
+
+void PointIndex::add(const Point& p) {
+    if (gridStale) buildGrid();
+    points.push_back(p);
+    link(uint32_t(points.size() - 1));
+}
+
+void PointIndex::assign(const float* xs, const float* ys, size_t n) {
+    points.clear();
+    points.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+        points.emplace_back(xs[i], ys[i]);
+    next.clear();
+    heads.clear();
+    gridStale = n > 0;
+}
+
+// Takes i out of its cell's chain, dropping the cell once it is empty
+void PointIndex::unlink(const Cell& c, uint32_t i) {
+    auto head = heads.find(c);
+    if (head->second == i) {
+        if (next[i] == none)
+            heads.erase(head);
+        else
+            head->second = next[i];
+        return;
+    }
+    uint32_t prev = head->second;
+    while (next[prev] != i)
+        prev = next[prev];
+    next[prev] = next[i];
+}
+
+// Points the chain entry for from at to instead
+void PointIndex::relink(const Cell& c, uint32_t from, uint32_t to) {
+    auto head = heads.find(c);
+    if (head->second == from) {
+        head->second = to;
+        return;
+    }
+    uint32_t prev = head->second;
+    while (next[prev] != from)
+        prev = next[prev];
+    next[prev] = to;
+}
+
+void PointIndex::removeAt(size_t i) {
+    if (gridStale) buildGrid();
+    uint32_t hole = uint32_t(i);
+    uint32_t last = uint32_t(points.size() - 1);
+    unlink(cellOf(points[hole].getX(), points[hole].getY()), hole);
+    if (hole != last) {
+        relink(cellOf(points[last].getX(), points[last].getY()), last, hole);
+        points[hole] = points[last];
+        next[hole] = next[last];
+    }
+    points.pop_back();
+    next.pop_back();
+}
+
+size_t PointIndex::removeNear(float x, float y) {
+    return removeNear(x, y, [](const Point&) {});
+}
+
+void PointIndex::clear() {
+    points.clear();
+    next.clear();
+    heads.clear();
+    gridStale = false;
+}
+
+void PointIndex::reserve(size_t n) {
+    points.reserve(n);
+    next.reserve(n);
+    heads.reserve(n);
+}
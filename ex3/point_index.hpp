@@ -0,0 +1,89 @@
+#ifndef POINT_INDEX_HPP
+#define POINT_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "point.hpp"
+
+// Points in a dense array plus a uniform-grid hash over them, for the
+// servers' tolerance matching: two points match when they are less than
+// the tolerance apart on both axes. Cells are about as wide as the
+// tolerance, so a match is always in the 3x3 cells around a point, and
+// lookup, insert and removal take expected O(1). Removal swaps the last
+// point into the hole, so the array stays dense (and usable as a hull
+// view) but its order changes.
+class PointIndex {
+public:
+    static const size_t npos = ~size_t(0);
+    static const size_t maxSize = 0xFFFFFFFEu; // the chains index in uint32, none excluded
+
+    explicit PointIndex(float tolerance = 0.001f);
+
+    // Index of a point matching (x, y), or npos
+    size_t findNear(float x, float y) const;
+    bool containsNear(float x, float y) const { return findNear(x, y) != npos; }
+
+    // Appends without a duplicate check
+    void add(const Point& p);
+
+    // Replaces the points with xs, ys, without a duplicate check. The grid
+    // is built on the first lookup, add or removal after this, so a loaded
+    // graph that is only hulled never pays for it.
+    void assign(const float* xs, const float* ys, size_t n);
+    void removeAt(size_t i);
+
+    // Removes every point matching (x, y), handing each to removed() just
+    // before it goes; returns how many there were
+    template <typename Removed>
+    size_t removeNear(float x, float y, Removed removed) {
+        size_t count = 0;
+        for (size_t i = findNear(x, y); i != npos; i = findNear(x, y)) {
+            removed(points[i]);
+            removeAt(i);
+            ++count;
+        }
+        return count;
+    }
+    size_t removeNear(float x, float y);
+
+    void clear();
+    void reserve(size_t n);
+
+    size_t size() const { return points.size(); }
+    bool empty() const { return points.empty(); }
+    const Point* data() const { return points.data(); }
+    const Point& operator[](size_t i) const { return points[i]; }
+    const Point& back() const { return points.back(); }
+    std::vector<Point>::const_iterator begin() const { return points.begin(); }
+    std::vector<Point>::const_iterator end() const { return points.end(); }
+
+private:
+    struct Cell {
+        int64_t x, y;
+        bool operator==(const Cell& other) const { return x == other.x && y == other.y; }
+    };
+    struct CellHash {
+        size_t operator()(const Cell& c) const;
+    };
+
+    static const uint32_t none = ~uint32_t(0);
+
+    float tolerance;
+    double inverseCell;
+    std::vector<Point> points;
+    // The grid; const lookups build it while it is stale
+    mutable std::vector<uint32_t> next; // next point in the same cell, or none
+    mutable std::unordered_map<Cell, uint32_t, CellHash> heads;
+    mutable bool gridStale = false;
+
+    Cell cellOf(float x, float y) const;
+    void link(uint32_t i) const;
+    void buildGrid() const;
+    bool matches(const Point& p, float x, float y) const;
+    void unlink(const Cell& c, uint32_t i);
+    void relink(const Cell& c, uint32_t from, uint32_t to);
+};
+
+#endif
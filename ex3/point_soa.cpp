@@ -0,0 +1,20 @@
+#include "point_soa.hpp"
+
+PointSoA::PointSoA(const std::vector<Point>& points) {
+    reserve(points.size());
+    for (const auto& p : points)
+        push_back(p);
+}
+
+std::vector<Point> PointSoA::toPoints() const {
+    std::vector<Point> points;
+    soaToPoints(xs.data(), ys.data(), size(), points);
+    return points;
+}
+
+void soaToPoints(const float* xs, const float* ys, size_t n, std::vector<Point>& out) {
+    out.clear();
+    out.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+        out.emplace_back(xs[i], ys[i]);
+}
@@ -0,0 +1,71 @@
+#ifndef POINT_SOA_HPP
+#define POINT_SOA_HPP
+
+#include <cstddef>
+#include <stdlib.h>
+#include <new>
+#include <vector>
+#include "point.hpp"
+
+// Allocator returning 32-byte aligned storage, enough for AVX2 loads
+template <typename T>
+struct AlignedAllocator {
+    typedef T value_type;
+    static const size_t alignment = 32;
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        void* p = nullptr;
+        if (posix_memalign(&p, alignment, n * sizeof(T)) != 0)
+            throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+    void deallocate(T* p, size_t) { std::free(p); }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U>&) const { return false; }
+};
+
+// Structure-of-arrays point storage: separate aligned x[] and y[] arrays
+// so hot loops can run the SIMD kernels over them directly.
+class PointSoA {
+public:
+    typedef std::vector<float, AlignedAllocator<float>> FloatArray;
+
+    PointSoA() = default;
+    explicit PointSoA(const std::vector<Point>& points);
+
+    size_t size() const { return xs.size(); }
+    bool empty() const { return xs.empty(); }
+    void reserve(size_t n) { xs.reserve(n); ys.reserve(n); }
+    void clear() { xs.clear(); ys.clear(); }
+
+    void push_back(float x, float y) { xs.push_back(x); ys.push_back(y); }
+    void push_back(const Point& p) { push_back(p.getX(), p.getY()); }
+
+    float x(size_t i) const { return xs[i]; }
+    float y(size_t i) const { return ys[i]; }
+    Point at(size_t i) const { return Point(xs[i], ys[i]); }
+
+    const float* xData() const { return xs.data(); }
+    const float* yData() const { return ys.data(); }
+    float* xData() { return xs.data(); }
+    float* yData() { return ys.data(); }
+
+    std::vector<Point> toPoints() const;
+
+private:
+    FloatArray xs;
+    FloatArray ys;
+};
+
+// Points of separate x and y arrays that a PointSoA does not own, such as
+// a mapped point file (point_file.hpp)
+void soaToPoints(const float* xs, const float* ys, size_t n, std::vector<Point>& out);
+
+#endif
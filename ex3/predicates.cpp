@@ -0,0 +1,127 @@
+#include "predicates.hpp"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+thread_local OrientCounters orientCounters = {{0}, {0}, false};
+
+struct OrientRegistry {
+    std::mutex mutex;
+    std::vector<OrientCounters*> live;
+    uint64_t retiredCalls = 0;  // from threads that have exited
+    uint64_t retiredExact = 0;
+    OrientStats base = {0, 0};  // totals at the last reset
+};
+
+// Never destroyed, so threads exiting after main() can still retire
+static OrientRegistry& registry() {
+    static OrientRegistry* r = new OrientRegistry;
+    return *r;
+}
+
+// Folds the thread's counts into the retired totals when it exits. Only
+// registration touches it, so orient2d() itself never pays for a
+// thread_local with a destructor.
+struct OrientRetirer {
+    ~OrientRetirer() {
+        OrientRegistry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.retiredCalls += orientCounters.calls.load(std::memory_order_relaxed);
+        r.retiredExact += orientCounters.exact.load(std::memory_order_relaxed);
+        r.live.erase(std::find(r.live.begin(), r.live.end(), &orientCounters));
+    }
+};
+
+void registerOrientCounters() {
+    static thread_local OrientRetirer retirer;
+    (void)retirer;
+    OrientRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.live.push_back(&orientCounters);
+    orientCounters.registered = true;
+}
+
+// Knuth's two-sum: x + y == a + b exactly, with x = fl(a + b)
+static inline void twoSum(double a, double b, double& x, double& y) {
+    x = a + b;
+    double bv = x - a;
+    double av = x - bv;
+    y = (a - av) + (b - bv);
+}
+
+// Sign of a sum of doubles: the terms are summed into a nonoverlapping
+// expansion (Shewchuk's grow-expansion with zero elimination) whose
+// largest component carries the sign
+static int expansionSign(const double* terms, int n) {
+    double e[12];
+    int len = 0;
+    for (int t = 0; t < n; ++t) {
+        double q = terms[t];
+        int k = 0;
+        for (int i = 0; i < len; ++i) {
+            double sum, err;
+            twoSum(q, e[i], sum, err);
+            q = sum;
+            if (err != 0.0) e[k++] = err;
+        }
+        if (q != 0.0) e[k++] = q;
+        len = k;
+    }
+    if (len == 0) return 0;
+    return e[len - 1] > 0.0 ? +1 : -1;
+}
+
+static inline void countExact() {
+    orientCounters.exact.store(orientCounters.exact.load(std::memory_order_relaxed) + 1,
+                               std::memory_order_relaxed);
+}
+
+// Expanded, the determinant is a sum of six coordinate products, and a
+// product of two floats always fits a double
+int orient2dExact(float ax, float ay, float bx, float by, float cx, float cy) {
+    countExact();
+    const double terms[6] = {double(bx) * cy, -(double(bx) * ay), -(double(ax) * cy),
+                             -(double(by) * cx), double(ax) * by, double(ay) * cx};
+    return expansionSign(terms, 6);
+}
+
+// Double products are split into head and tail with fma, giving twelve
+// exact terms
+int orient2dExact(double ax, double ay, double bx, double by, double cx, double cy) {
+    countExact();
+    const double a[6] = {bx, -bx, -ax, -by, ax, ay};
+    const double b[6] = {cy, ay, cy, cx, by, cx};
+    double terms[12];
+    for (int i = 0; i < 6; ++i) {
+        terms[2 * i] = a[i] * b[i];
+        terms[2 * i + 1] = std::fma(a[i], b[i], -terms[2 * i]);
+    }
+    return expansionSign(terms, 12);
+}
+
+// Sum over live and exited threads. A live thread's count may lag by the
+// calls it has in flight.
+static OrientStats totals(OrientRegistry& r) {
+    OrientStats s = {r.retiredCalls, r.retiredExact};
+    for (const OrientCounters* c : r.live) {
+        s.calls += c->calls.load(std::memory_order_relaxed);
+        s.exact += c->exact.load(std::memory_order_relaxed);
+    }
+    return s;
+}
+
+OrientStats orientStats() {
+    OrientRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    OrientStats s = totals(r);
+    s.calls -= r.base.calls;
+    s.exact -= r.base.exact;
+    return s;
+}
+
+void resetOrientStats() {
+    OrientRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.base = totals(r);
+}
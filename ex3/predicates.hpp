@@ -0,0 +1,81 @@
+#ifndef PREDICATES_HPP
+#define PREDICATES_HPP
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include "point.hpp"
+
+// Calls and exact fallbacks since start or the last reset, over all threads
+struct OrientStats {
+    uint64_t calls;
+    uint64_t exact;
+};
+
+OrientStats orientStats();
+void resetOrientStats();
+
+// Per-thread counters behind orientStats(). Only the owning thread writes
+// them, so bumping is a plain load and store; other threads only read.
+struct OrientCounters {
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> exact;
+    bool registered;
+};
+
+extern thread_local OrientCounters orientCounters;
+
+void registerOrientCounters();
+int orient2dExact(float ax, float ay, float bx, float by, float cx, float cy);
+int orient2dExact(double ax, double ay, double bx, double by, double cx, double cy);
+
+// Shewchuk's ccwerrboundA: a double determinant detLeft - detRight of
+// orientation has the right sign when its magnitude exceeds this fraction
+// of |detLeft| + |detRight|, or when either side is zero
+const double orientErrBound = (3.0 + 16.0 * 1.1102230246251565e-16) * 1.1102230246251565e-16;
+
+// Counts the call and evaluates the determinant in double. Returns true
+// with the sign when it clears Shewchuk's forward error bound
+// (ccwerrboundA), false when only an exact evaluation can tell.
+inline bool orient2dFilter(double ax, double ay, double bx, double by, double cx, double cy,
+                           int& sign) {
+    OrientCounters& counters = orientCounters;
+    if (!counters.registered)
+        registerOrientCounters();
+    counters.calls.store(counters.calls.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+
+    double detLeft = (ax - cx) * (by - cy);
+    double detRight = (ay - cy) * (bx - cx);
+    double det = detLeft - detRight;
+    sign = (det > 0.0) - (det < 0.0);
+
+    // Sides of opposite sign cannot cancel and always clear the bound; with
+    // a zero side the other one's sign is already exact
+    double bound = orientErrBound * (std::fabs(detLeft) + std::fabs(detRight));
+    return std::fabs(det) > bound || detLeft == 0.0 || detRight == 0.0;
+}
+
+// Orientation of (a, b, c): +1 counterclockwise, -1 clockwise, 0 collinear.
+// Exact for every input; only cases the double filter cannot settle reach
+// orient2dExact().
+inline int orient2d(float ax, float ay, float bx, float by, float cx, float cy) {
+    int sign;
+    if (orient2dFilter(ax, ay, bx, by, cx, cy, sign))
+        return sign;
+    return orient2dExact(ax, ay, bx, by, cx, cy);
+}
+
+// Same for double coordinates, barring overflow and underflow
+inline int orient2d(double ax, double ay, double bx, double by, double cx, double cy) {
+    int sign;
+    if (orient2dFilter(ax, ay, bx, by, cx, cy, sign))
+        return sign;
+    return orient2dExact(ax, ay, bx, by, cx, cy);
+}
+
+inline int orient2d(const Point& a, const Point& b, const Point& c) {
+    return orient2d(a.getX(), a.getY(), b.getX(), b.getY(), c.getX(), c.getY());
+}
+
+#endif
@@ -0,0 +1,153 @@
+#include "prefilter.hpp"
+#include "predicates.hpp"
+#include "simd_kernels.hpp"
+#include <cmath>
+#include <cstdint>
+
+// A point just outside an octagon edge can be a hull vertex, so the double
+// cross product (b - a) x (c - a) only settles points clearly inside, and
+// the few others, kept points included, are decided by orient2d. Over a
+// w x h bounding box both products of an edge are capped, which makes
+// orient2d's error bound (doubled for slack) one margin per edge.
+static double edgeMargin(double dx, double dy, double w, double h) {
+    return 2.0 * orientErrBound * (std::fabs(dx) * h + std::fabs(dy) * w);
+}
+
+size_t aklToussaintFilter(const std::vector<Point>& in, std::vector<Point>& out) {
+    return aklToussaintFilter(in.data(), in.size(), out);
+}
+
+size_t aklToussaintFilter(const Point* in, size_t n, std::vector<Point>& out) {
+    out.clear();
+    if (n < 9) {
+        out.assign(in, in + n);
+        return 0;
+    }
+
+    // One pass over the points: index of the extreme in each direction,
+    // listed counterclockwise starting from the left
+    // 0: min x, 1: min x+y, 2: min y, 3: max x-y,
+    // 4: max x, 5: max x+y, 6: max y, 7: min x-y
+    float best[8];
+    size_t idx[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    {
+        float x = in[0].getX(), y = in[0].getY();
+        best[0] = x;     best[4] = x;
+        best[2] = y;     best[6] = y;
+        best[1] = x + y; best[5] = x + y;
+        best[3] = x - y; best[7] = x - y;
+    }
+    for (size_t i = 1; i < n; ++i) {
+        float x = in[i].getX(), y = in[i].getY();
+        float s = x + y, d = x - y;
+        idx[0] = x < best[0] ? i : idx[0]; best[0] = x < best[0] ? x : best[0];
+        idx[1] = s < best[1] ? i : idx[1]; best[1] = s < best[1] ? s : best[1];
+        idx[2] = y < best[2] ? i : idx[2]; best[2] = y < best[2] ? y : best[2];
+        idx[3] = d > best[3] ? i : idx[3]; best[3] = d > best[3] ? d : best[3];
+        idx[4] = x > best[4] ? i : idx[4]; best[4] = x > best[4] ? x : best[4];
+        idx[5] = s > best[5] ? i : idx[5]; best[5] = s > best[5] ? s : best[5];
+        idx[6] = y > best[6] ? i : idx[6]; best[6] = y > best[6] ? y : best[6];
+        idx[7] = d < best[7] ? i : idx[7]; best[7] = d < best[7] ? d : best[7];
+    }
+
+    // Octagon edges, skipping repeated vertices
+    double ex[8], ey[8], dx[8], dy[8];
+    const Point* from[8];
+    const Point* to[8];
+    int edges = 0;
+    for (int k = 0; k < 8; ++k) {
+        const Point& a = in[idx[k]];
+        const Point& b = in[idx[(k + 1) % 8]];
+        if (a == b) continue;
+        ex[edges] = a.getX();
+        ey[edges] = a.getY();
+        dx[edges] = static_cast<double>(b.getX()) - a.getX();
+        dy[edges] = static_cast<double>(b.getY()) - a.getY();
+        from[edges] = &a;
+        to[edges] = &b;
+        ++edges;
+    }
+    if (edges < 3) {
+        out.assign(in, in + n);
+        return 0;
+    }
+
+    // Keep points on or outside the octagon
+    double w = double(best[4]) - best[0], h = double(best[6]) - best[2];
+    double margin[8];
+    for (int k = 0; k < edges; ++k)
+        margin[k] = edgeMargin(dx[k], dy[k], w, h);
+    out.reserve(n / 4);
+    for (size_t i = 0; i < n; ++i) {
+        double px = in[i].getX(), py = in[i].getY();
+        bool inside = true;
+        for (int k = 0; k < edges; ++k)
+            inside &= dx[k] * (py - ey[k]) - dy[k] * (px - ex[k]) > margin[k];
+        if (!inside) {
+            inside = true;
+            for (int k = 0; k < edges; ++k)
+                inside &= orient2d(*from[k], *to[k], in[i]) > 0;
+        }
+        if (!inside)
+            out.push_back(in[i]);
+    }
+    return n - out.size();
+}
+
+size_t aklToussaintFilter(const PointSoA& in, std::vector<Point>& out) {
+    return aklToussaintFilter(in.xData(), in.yData(), in.size(), out);
+}
+
+size_t aklToussaintFilter(const float* x, const float* y, size_t n, std::vector<Point>& out) {
+    out.clear();
+    if (n < 9) {
+        soaToPoints(x, y, n, out);
+        return 0;
+    }
+
+    size_t idx[8];
+    extremePoints(x, y, n, idx);
+
+    // Octagon edges, skipping repeated vertices
+    size_t from[8], to[8];
+    int edges = 0;
+    for (int k = 0; k < 8; ++k) {
+        size_t a = idx[k], b = idx[(k + 1) % 8];
+        if (x[a] == x[b] && y[a] == y[b]) continue;
+        from[edges] = a;
+        to[edges] = b;
+        ++edges;
+    }
+    if (edges < 3) {
+        soaToPoints(x, y, n, out);
+        return 0;
+    }
+
+    double w = double(x[idx[4]]) - x[idx[0]], h = double(y[idx[6]]) - y[idx[2]];
+    double margin[8];
+    for (int k = 0; k < edges; ++k)
+        margin[k] = edgeMargin(double(x[to[k]]) - x[from[k]], double(y[to[k]]) - y[from[k]], w, h);
+
+    // Blocks small enough for the flags to stay in L1
+    const size_t block = 1024;
+    uint8_t inside[block];
+    out.reserve(n / 4);
+    for (size_t start = 0; start < n; start += block) {
+        size_t len = n - start < block ? n - start : block;
+        for (size_t j = 0; j < len; ++j)
+            inside[j] = 1;
+        for (int k = 0; k < edges; ++k)
+            leftOfBatch(x[from[k]], y[from[k]], x[to[k]], y[to[k]], margin[k],
+                        x + start, y + start, len, inside);
+        for (size_t j = 0; j < len; ++j) {
+            if (inside[j]) continue;
+            size_t i = start + j;
+            bool exact = true;
+            for (int k = 0; k < edges; ++k)
+                exact &= orient2d(x[from[k]], y[from[k]], x[to[k]], y[to[k]], x[i], y[i]) > 0;
+            if (!exact)
+                out.emplace_back(x[i], y[i]);
+        }
+    }
+    return n - out.size();
+}
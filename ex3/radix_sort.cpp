@@ -0,0 +1,154 @@
+#include "radix_sort.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <functional>
+
+static const int digitBits = 11;
+static const size_t buckets = size_t(1) << digitBits;
+static const uint64_t digitMask = buckets - 1;
+static const int passes = (64 + digitBits - 1) / digitBits;
+static const size_t parallelHistogram = size_t(1) << 16;
+
+// Adds the digits of key to one chunk's histograms (one per pass)
+static inline void countKey(size_t* c, uint64_t key) {
+    for (int p = 0; p < passes; ++p)
+        ++c[p * buckets + ((key >> (p * digitBits)) & digitMask)];
+}
+
+// Runs body(chunk, begin, end) over [0, n) with one histogram set per
+// chunk, then folds them into the first set
+static void countDigits(size_t n, ThreadPool* pool, std::vector<size_t>& counts,
+                        const std::function<void(size_t*, size_t, size_t)>& body) {
+    size_t chunks = pool != nullptr && n >= parallelHistogram ? pool->size() : 1;
+    size_t set = passes * buckets;
+    counts.assign(chunks * set, 0);
+    if (chunks > 1) {
+        pool->parallelFor(n, chunks, [&](size_t chunk, size_t begin, size_t end) {
+            body(&counts[chunk * set], begin, end);
+        });
+        for (size_t c = 1; c < chunks; ++c)
+            for (size_t i = 0; i < set; ++i)
+                counts[i] += counts[c * set + i];
+    } else {
+        body(counts.data(), 0, n);
+    }
+}
+
+// LSD scatter passes between src and dst; returns whichever holds the result.
+// touch(item) runs a fixed distance ahead of the item being scattered, so
+// keys read through an index can be prefetched.
+static const size_t prefetchAhead = 16;
+
+template <typename Item, typename KeyOf, typename Touch>
+static Item* scatterPasses(Item* src, Item* dst, size_t n, size_t* counts, KeyOf keyOf, Touch touch) {
+    for (int p = 0; p < passes; ++p) {
+        size_t* c = counts + p * buckets;
+        int shift = p * digitBits;
+        if (c[(keyOf(src[0]) >> shift) & digitMask] == n)
+            continue; // every key has this digit
+        size_t sum = 0;
+        for (size_t b = 0; b < buckets; ++b) {
+            size_t count = c[b];
+            c[b] = sum;
+            sum += count;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            if (i + prefetchAhead < n)
+                touch(src[i + prefetchAhead]);
+            dst[c[(keyOf(src[i]) >> shift) & digitMask]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+    return src;
+}
+
+void RadixSorter::sortByXY(Point* pts, size_t n, ThreadPool* pool) {
+    if (n < smallInput) {
+        std::sort(pts, pts + n, [](const Point& a, const Point& b) {
+            if (a.getX() != b.getX())
+                return a.getX() < b.getX();
+            return a.getY() < b.getY();
+        });
+        return;
+    }
+
+    // The key encodes the point exactly (up to the sign of zero), so only
+    // keys move between passes
+    keyScratch.resize(n);
+    keyBuffer.resize(n);
+    countDigits(n, pool, counts, [&](size_t* c, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            uint64_t key = packKeys(pts[i].getX(), pts[i].getY());
+            keyScratch[i] = key;
+            countKey(c, key);
+        }
+    });
+    const uint64_t* sorted = scatterPasses(keyScratch.data(), keyBuffer.data(), n, counts.data(),
+                                           [](uint64_t k) { return k; }, [](uint64_t) {});
+    for (size_t i = 0; i < n; ++i)
+        pts[i] = Point(keyFloat(uint32_t(sorted[i] >> 32)), keyFloat(uint32_t(sorted[i])));
+}
+
+// (key, index) pairs for keys[0..n), sorted by key; the index breaks ties,
+// so the order is stable
+const std::pair<uint64_t, uint32_t>* RadixSorter::sortItems(const uint64_t* keys, size_t n,
+                                                            ThreadPool* pool) {
+    itemScratch.resize(n);
+    itemBuffer.resize(n);
+    if (n < smallInput) {
+        for (size_t i = 0; i < n; ++i)
+            itemScratch[i] = std::make_pair(keys[i], uint32_t(i));
+        std::sort(itemScratch.begin(), itemScratch.end());
+        return itemScratch.data();
+    }
+    countDigits(n, pool, counts, [&](size_t* c, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            itemScratch[i] = std::make_pair(keys[i], uint32_t(i));
+            countKey(c, keys[i]);
+        }
+    });
+    return scatterPasses(itemScratch.data(), itemBuffer.data(), n, counts.data(),
+                         [](const std::pair<uint64_t, uint32_t>& item) { return item.first; },
+                         [](const std::pair<uint64_t, uint32_t>&) {});
+}
+
+void RadixSorter::sortByKey(Point* pts, uint64_t* keys, size_t n, ThreadPool* pool) {
+    const std::pair<uint64_t, uint32_t>* sorted = sortItems(keys, n, pool);
+    pointScratch.assign(pts, pts + n);
+    for (size_t i = 0; i < n; ++i) {
+        pts[i] = pointScratch[sorted[i].second];
+        keys[i] = sorted[i].first;
+    }
+}
+
+void RadixSorter::sortIndexByKey(uint64_t* keys, size_t n, std::vector<uint32_t>& order,
+                                 ThreadPool* pool) {
+    const std::pair<uint64_t, uint32_t>* sorted = sortItems(keys, n, pool);
+    order.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        order[i] = sorted[i].second;
+        keys[i] = sorted[i].first;
+    }
+}
+
+void RadixSorter::sortIndexByXY(const Point* pts, size_t n, std::vector<uint32_t>& order,
+                                ThreadPool* pool) {
+    order.resize(n);
+    for (size_t i = 0; i < n; ++i)
+        order[i] = uint32_t(i);
+    auto keyOf = [pts](uint32_t i) { return packKeys(pts[i].getX(), pts[i].getY()); };
+    if (n < smallInput) {
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keyOf(a) < keyOf(b); });
+        return;
+    }
+
+    indexBuffer.resize(n);
+    countDigits(n, pool, counts, [&](size_t* c, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            countKey(c, keyOf(uint32_t(i)));
+    });
+    const uint32_t* sorted = scatterPasses(order.data(), indexBuffer.data(), n, counts.data(), keyOf,
+                                           [pts](uint32_t i) { __builtin_prefetch(pts + i); });
+    if (sorted != order.data())
+        order.swap(indexBuffer);
+}
@@ -0,0 +1,75 @@
+#ifndef RADIX_SORT_HPP
+#define RADIX_SORT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+#include "point.hpp"
+
+class ThreadPool;
+
+// Order-preserving map from an IEEE-754 float to an unsigned key: negative
+// values have every bit flipped, non-negative ones only the sign bit.
+// -0.0 compares equal to +0.0, so it is taken as +0.0 first.
+inline uint32_t floatKey(float f) {
+    f += 0.0f; // -0.0 + 0.0 is +0.0; every other value is unchanged
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    return u ^ ((u >> 31) != 0 ? 0xFFFFFFFFu : 0x80000000u);
+}
+
+inline float keyFloat(uint32_t k) {
+    uint32_t u = k ^ ((k >> 31) != 0 ? 0x80000000u : 0xFFFFFFFFu);
+    float f;
+    std::memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+// 64-bit key ordering by hi, then lo
+inline uint64_t packKeys(float hi, float lo) {
+    return (uint64_t(floatKey(hi)) << 32) | floatKey(lo);
+}
+
+// LSD radix sort over 64-bit keys with 11-bit digits (at most 6 passes).
+// Digit histograms for all passes come from one read of the keys, split
+// across a pool when one is given; passes where every key shares the
+// digit are skipped. Scratch buffers are kept between calls.
+class RadixSorter {
+public:
+    // Points by (x, y), same order as a lexicographic std::sort; a -0.0
+    // coordinate comes back as +0.0
+    void sortByXY(Point* pts, size_t n, ThreadPool* pool = nullptr);
+
+    // Points by a precomputed key (e.g. packKeys(angle, distance)), stable;
+    // keys are sorted along with the points
+    void sortByKey(Point* pts, uint64_t* keys, size_t n, ThreadPool* pool = nullptr);
+
+    // Indices 0..n-1 into order, sorted by keys[index], stable; only the
+    // (key, index) pairs move, and keys end up sorted with them
+    void sortIndexByKey(uint64_t* keys, size_t n, std::vector<uint32_t>& order,
+                        ThreadPool* pool = nullptr);
+
+    // Indices 0..n-1 into order, sorted by the (x, y) of pts[index]; the
+    // points stay where they are. Each pass rereads the key through the
+    // index, so the only scratch is a second index buffer.
+    void sortIndexByXY(const Point* pts, size_t n, std::vector<uint32_t>& order,
+                       ThreadPool* pool = nullptr);
+
+    // Below this many points std::sort is faster
+    static const size_t smallInput = 256;
+
+private:
+    const std::pair<uint64_t, uint32_t>* sortItems(const uint64_t* keys, size_t n, ThreadPool* pool);
+
+    std::vector<uint64_t> keyScratch;
+    std::vector<uint64_t> keyBuffer;
+    std::vector<std::pair<uint64_t, uint32_t>> itemScratch;
+    std::vector<std::pair<uint64_t, uint32_t>> itemBuffer;
+    std::vector<Point> pointScratch;
+    std::vector<uint32_t> indexBuffer;
+    std::vector<size_t> counts;
+};
+
+#endif
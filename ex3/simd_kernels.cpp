@@ -0,0 +1,636 @@
+#include "simd_kernels.hpp"
+#include "predicates.hpp"
+#include "radix_sort.hpp"
+#include <atomic>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HULL_SIMD_X86 1
+#endif
+
+// Slots of extremePoints() holding minima and maxima of x, x+y, y, x-y
+static const int minSlot[4] = {0, 1, 2, 7};
+static const int maxSlot[4] = {4, 5, 6, 3};
+
+//------------------- Scalar kernels ------------------------------------
+
+// The determinant in double, as orient2d filters it; lanes inside the
+// error bound are settled by orient2dExact()
+static void orientationScalar(float ax, float ay, float bx, float by,
+                              const float* cx, const float* cy, size_t n, int8_t* out) {
+    double dx = static_cast<double>(bx) - ax, dy = static_cast<double>(by) - ay;
+    for (size_t i = 0; i < n; ++i) {
+        double l = dx * (static_cast<double>(cy[i]) - ay);
+        double r = dy * (static_cast<double>(cx[i]) - ax);
+        double v = l - r;
+        if (std::fabs(v) > orientErrBound * (std::fabs(l) + std::fabs(r)) || l == 0.0 || r == 0.0)
+            out[i] = (v > 0) - (v < 0);
+        else
+            out[i] = int8_t(orient2dExact(ax, ay, bx, by, cx[i], cy[i]));
+    }
+}
+
+static void leftOfScalar(float ax, float ay, float bx, float by, double margin,
+                         const float* cx, const float* cy, size_t n, uint8_t* inside) {
+    double dx = static_cast<double>(bx) - ax, dy = static_cast<double>(by) - ay;
+    for (size_t i = 0; i < n; ++i) {
+        double v = dx * (static_cast<double>(cy[i]) - ay) - dy * (static_cast<double>(cx[i]) - ax);
+        inside[i] &= v > margin;
+    }
+}
+
+static void orientationGridScalar(int32_t ax, int32_t ay, int32_t bx, int32_t by,
+                                  const int32_t* cx, const int32_t* cy, size_t n, int8_t* out) {
+    int64_t dx = int64_t(bx) - ax, dy = int64_t(by) - ay;
+    for (size_t i = 0; i < n; ++i) {
+        int64_t v = dx * (int64_t(cy[i]) - ay) - dy * (int64_t(cx[i]) - ax);
+        out[i] = (v > 0) - (v < 0);
+    }
+}
+
+// Terms x[i] * y[i + 1] - x[i + 1] * y[i] for i in [from, n), wrapping at the end
+static double shoelaceTail(const float* x, const float* y, size_t from, size_t n) {
+    double sum = 0.0;
+    for (size_t i = from; i < n; ++i) {
+        size_t j = i + 1 == n ? 0 : i + 1;
+        sum += static_cast<double>(x[i]) * y[j] - static_cast<double>(x[j]) * y[i];
+    }
+    return sum;
+}
+
+// best[] in extremePoints order; updates from points [from, n)
+static void extremeValuesTail(const float* x, const float* y, size_t from, size_t n, float best[8]) {
+    for (size_t i = from; i < n; ++i) {
+        float s = x[i] + y[i], d = x[i] - y[i];
+        best[0] = x[i] < best[0] ? x[i] : best[0];
+        best[1] = s < best[1] ? s : best[1];
+        best[2] = y[i] < best[2] ? y[i] : best[2];
+        best[3] = d > best[3] ? d : best[3];
+        best[4] = x[i] > best[4] ? x[i] : best[4];
+        best[5] = s > best[5] ? s : best[5];
+        best[6] = y[i] > best[6] ? y[i] : best[6];
+        best[7] = d < best[7] ? d : best[7];
+    }
+}
+
+// First index in [from, n) reaching each still-missing extreme value
+static int extremeIndicesTail(const float* x, const float* y, size_t from, size_t n,
+                              const float best[8], bool found[8], size_t idx[8], int missing) {
+    for (size_t i = from; i < n && missing > 0; ++i) {
+        float v[8] = {x[i], x[i] + y[i], y[i], x[i] - y[i], x[i], x[i] + y[i], y[i], x[i] - y[i]};
+        for (int k = 0; k < 8; ++k) {
+            if (!found[k] && v[k] == best[k]) {
+                found[k] = true;
+                idx[k] = i;
+                --missing;
+            }
+        }
+    }
+    return missing;
+}
+
+static void pseudoAngleKeysScalar(const float* x, const float* y, size_t n, float x0, float y0,
+                                  uint64_t* keys) {
+    for (size_t i = 0; i < n; ++i) {
+        double dx = static_cast<double>(x[i]) - x0, dy = static_cast<double>(y[i]) - y0;
+        double s = std::fabs(dx) + dy;
+        float angle = s > 0.0 ? static_cast<float>(dx / s) : -2.0f;
+        keys[i] = packKeys(angle, static_cast<float>(dx * dx + dy * dy));
+    }
+}
+
+// Batcher's merge exchange on up to 16 keys as (a, b) index pairs: the
+// network tiny_hull.hpp unrolls, in the same order
+struct KeyNetwork {
+    uint8_t a[64], b[64];
+    size_t size;
+};
+
+static KeyNetwork buildKeyNetwork(size_t n) {
+    KeyNetwork net;
+    net.size = 0;
+    for (size_t p = 1; p < n; p <<= 1)
+        for (size_t s = p; s > 0; s >>= 1)
+            for (size_t j = s % p; j + s < n; j += 2 * s)
+                for (size_t i = 0; i < s && i + j + s < n; ++i)
+                    if ((i + j) / (2 * p) == (i + j + s) / (2 * p)) {
+                        net.a[net.size] = uint8_t(i + j);
+                        net.b[net.size] = uint8_t(i + j + s);
+                        ++net.size;
+                    }
+    return net;
+}
+
+static const KeyNetwork& keyNetwork(size_t n) {
+    static const struct Table {
+        KeyNetwork nets[17];
+        Table() {
+            for (size_t i = 0; i <= 16; ++i)
+                nets[i] = buildKeyNetwork(i);
+        }
+    } table;
+    return table.nets[n];
+}
+
+static void sortKeyLanesScalar(uint64_t* keys, const KeyNetwork& net) {
+    for (size_t c = 0; c < net.size; ++c) {
+        uint64_t* a = keys + 4 * net.a[c];
+        uint64_t* b = keys + 4 * net.b[c];
+        for (int s = 0; s < 4; ++s) {
+            uint64_t lo = a[s] < b[s] ? a[s] : b[s];
+            uint64_t hi = a[s] < b[s] ? b[s] : a[s];
+            a[s] = lo;
+            b[s] = hi;
+        }
+    }
+}
+
+//------------------- SSE4.2 kernels ------------------------------------
+
+#ifdef HULL_SIMD_X86
+
+__attribute__((target("sse4.2")))
+static void orientationSse42(float ax, float ay, float bx, float by,
+                             const float* cx, const float* cy, size_t n, int8_t* out) {
+    double dxs = static_cast<double>(bx) - ax, dys = static_cast<double>(by) - ay;
+    __m128d dx = _mm_set1_pd(dxs), dy = _mm_set1_pd(dys);
+    __m128d vax = _mm_set1_pd(ax), vay = _mm_set1_pd(ay), zero = _mm_setzero_pd();
+    __m128d bound = _mm_set1_pd(orientErrBound), absMask = _mm_set1_pd(-0.0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 fx = _mm_loadu_ps(cx + i), fy = _mm_loadu_ps(cy + i);
+        __m128d px[2] = {_mm_cvtps_pd(fx), _mm_cvtps_pd(_mm_movehl_ps(fx, fx))};
+        __m128d py[2] = {_mm_cvtps_pd(fy), _mm_cvtps_pd(_mm_movehl_ps(fy, fy))};
+        for (int h = 0; h < 2; ++h) {
+            __m128d l = _mm_mul_pd(dx, _mm_sub_pd(py[h], vay));
+            __m128d r = _mm_mul_pd(dy, _mm_sub_pd(px[h], vax));
+            __m128d v = _mm_sub_pd(l, r);
+            __m128d err = _mm_mul_pd(bound, _mm_add_pd(_mm_andnot_pd(absMask, l),
+                                                       _mm_andnot_pd(absMask, r)));
+            __m128d sure = _mm_or_pd(_mm_cmpgt_pd(_mm_andnot_pd(absMask, v), err),
+                                     _mm_or_pd(_mm_cmpeq_pd(l, zero), _mm_cmpeq_pd(r, zero)));
+            int gt = _mm_movemask_pd(_mm_cmpgt_pd(v, zero));
+            int lt = _mm_movemask_pd(_mm_cmplt_pd(v, zero));
+            int unsure = ~_mm_movemask_pd(sure) & 3;
+            out[i + 2 * h] = (gt & 1) - (lt & 1);
+            out[i + 2 * h + 1] = ((gt >> 1) & 1) - ((lt >> 1) & 1);
+            for (; unsure != 0; unsure &= unsure - 1) {
+                size_t j = i + 2 * h + __builtin_ctz(unsure);
+                out[j] = int8_t(orient2dExact(ax, ay, bx, by, cx[j], cy[j]));
+            }
+        }
+    }
+    orientationScalar(ax, ay, bx, by, cx + i, cy + i, n - i, out + i);
+}
+
+__attribute__((target("sse4.2")))
+static void leftOfSse42(float ax, float ay, float bx, float by, double margin,
+                        const float* cx, const float* cy, size_t n, uint8_t* inside) {
+    double dxs = static_cast<double>(bx) - ax, dys = static_cast<double>(by) - ay;
+    __m128d dx = _mm_set1_pd(dxs), dy = _mm_set1_pd(dys);
+    __m128d vax = _mm_set1_pd(ax), vay = _mm_set1_pd(ay), m = _mm_set1_pd(margin);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 fx = _mm_loadu_ps(cx + i), fy = _mm_loadu_ps(cy + i);
+        __m128d px[2] = {_mm_cvtps_pd(fx), _mm_cvtps_pd(_mm_movehl_ps(fx, fx))};
+        __m128d py[2] = {_mm_cvtps_pd(fy), _mm_cvtps_pd(_mm_movehl_ps(fy, fy))};
+        for (int h = 0; h < 2; ++h) {
+            __m128d v = _mm_sub_pd(_mm_mul_pd(dx, _mm_sub_pd(py[h], vay)),
+                                   _mm_mul_pd(dy, _mm_sub_pd(px[h], vax)));
+            int left = _mm_movemask_pd(_mm_cmpgt_pd(v, m));
+            inside[i + 2 * h] &= left & 1;
+            inside[i + 2 * h + 1] &= (left >> 1) & 1;
+        }
+    }
+    leftOfScalar(ax, ay, bx, by, margin, cx + i, cy + i, n - i, inside + i);
+}
+
+// Differences stay in 32-bit lanes; mul_epi32 widens the even lanes to
+// exact 64-bit products, and the odd lanes after a 32-bit shift
+__attribute__((target("sse4.2")))
+static void orientationGridSse42(int32_t ax, int32_t ay, int32_t bx, int32_t by,
+                                 const int32_t* cx, const int32_t* cy, size_t n, int8_t* out) {
+    __m128i dx = _mm_set1_epi32(bx - ax), dy = _mm_set1_epi32(by - ay);
+    __m128i vax = _mm_set1_epi32(ax), vay = _mm_set1_epi32(ay), zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i px = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(cx + i)), vax);
+        __m128i py = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(cy + i)), vay);
+        for (int h = 0; h < 2; ++h) {
+            __m128i v = _mm_sub_epi64(_mm_mul_epi32(dx, py), _mm_mul_epi32(dy, px));
+            int gt = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(v, zero)));
+            int lt = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(zero, v)));
+            out[i + h] = (gt & 1) - (lt & 1);
+            out[i + h + 2] = ((gt >> 1) & 1) - ((lt >> 1) & 1);
+            px = _mm_srli_epi64(px, 32);
+            py = _mm_srli_epi64(py, 32);
+        }
+    }
+    orientationGridScalar(ax, ay, bx, by, cx + i, cy + i, n - i, out + i);
+}
+
+__attribute__((target("sse4.2")))
+static double shoelaceSse42(const float* x, const float* y, size_t n) {
+    __m128d acc = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 3 <= n; i += 2) {
+        __m128d xi = _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(x + i))));
+        __m128d yi = _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + i))));
+        __m128d xj = _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(x + i + 1))));
+        __m128d yj = _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + i + 1))));
+        acc = _mm_add_pd(acc, _mm_sub_pd(_mm_mul_pd(xi, yj), _mm_mul_pd(xj, yi)));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, acc);
+    return lanes[0] + lanes[1] + shoelaceTail(x, y, i, n);
+}
+
+__attribute__((target("sse4.2")))
+static void extremeValuesSse42(const float* x, const float* y, size_t n, float best[8]) {
+    __m128 mn[4], mx[4];
+    for (int k = 0; k < 4; ++k) {
+        mn[k] = _mm_set1_ps(best[minSlot[k]]);
+        mx[k] = _mm_set1_ps(best[maxSlot[k]]);
+    }
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 vx = _mm_loadu_ps(x + i), vy = _mm_loadu_ps(y + i);
+        __m128 v[4] = {vx, _mm_add_ps(vx, vy), vy, _mm_sub_ps(vx, vy)};
+        for (int k = 0; k < 4; ++k) {
+            mn[k] = _mm_min_ps(mn[k], v[k]);
+            mx[k] = _mm_max_ps(mx[k], v[k]);
+        }
+    }
+    float lo[4][4], hi[4][4];
+    for (int k = 0; k < 4; ++k) {
+        _mm_storeu_ps(lo[k], mn[k]);
+        _mm_storeu_ps(hi[k], mx[k]);
+    }
+    for (int k = 0; k < 4; ++k) {
+        for (int l = 0; l < 4; ++l) {
+            best[minSlot[k]] = lo[k][l] < best[minSlot[k]] ? lo[k][l] : best[minSlot[k]];
+            best[maxSlot[k]] = hi[k][l] > best[maxSlot[k]] ? hi[k][l] : best[maxSlot[k]];
+        }
+    }
+    extremeValuesTail(x, y, i, n, best);
+}
+
+// floatKey() on every lane
+__attribute__((target("sse4.2")))
+static inline __m128i floatKeys(__m128 f) {
+    __m128i u = _mm_castps_si128(_mm_add_ps(f, _mm_setzero_ps()));
+    return _mm_xor_si128(u, _mm_or_si128(_mm_srai_epi32(u, 31), _mm_set1_epi32(INT32_MIN)));
+}
+
+// Two points per step in double lanes; angle and distance keys are
+// interleaved into packKeys() order
+__attribute__((target("sse4.2")))
+static void pseudoAngleKeysSse42(const float* x, const float* y, size_t n, float x0, float y0,
+                                 uint64_t* keys) {
+    __m128d vx0 = _mm_set1_pd(x0), vy0 = _mm_set1_pd(y0), zero = _mm_setzero_pd();
+    __m128d pivot = _mm_set1_pd(-2.0), sign = _mm_set1_pd(-0.0);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128 fx = _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(x + i)));
+        __m128 fy = _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + i)));
+        __m128d dx = _mm_sub_pd(_mm_cvtps_pd(fx), vx0), dy = _mm_sub_pd(_mm_cvtps_pd(fy), vy0);
+        __m128d s = _mm_add_pd(_mm_andnot_pd(sign, dx), dy);
+        __m128d angle = _mm_blendv_pd(pivot, _mm_div_pd(dx, s), _mm_cmpgt_pd(s, zero));
+        __m128d dist = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+        __m128i a = floatKeys(_mm_cvtpd_ps(angle)), d = floatKeys(_mm_cvtpd_ps(dist));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(keys + i), _mm_unpacklo_epi32(d, a));
+    }
+    pseudoAngleKeysScalar(x + i, y + i, n - i, x0, y0, keys + i);
+}
+
+// Unsigned 64-bit compare-exchange as signed compares on sign-flipped keys
+__attribute__((target("sse4.2")))
+static void sortKeyLanesSse42(uint64_t* keys, const KeyNetwork& net) {
+    const __m128i flip = _mm_set1_epi64x(INT64_MIN);
+    for (size_t c = 0; c < net.size; ++c) {
+        for (int half = 0; half < 4; half += 2) {
+            __m128i* pa = reinterpret_cast<__m128i*>(keys + 4 * net.a[c] + half);
+            __m128i* pb = reinterpret_cast<__m128i*>(keys + 4 * net.b[c] + half);
+            __m128i a = _mm_loadu_si128(pa), b = _mm_loadu_si128(pb);
+            __m128i gt = _mm_cmpgt_epi64(_mm_xor_si128(a, flip), _mm_xor_si128(b, flip));
+            _mm_storeu_si128(pa, _mm_blendv_epi8(a, b, gt));
+            _mm_storeu_si128(pb, _mm_blendv_epi8(b, a, gt));
+        }
+    }
+}
+
+//------------------- AVX2 kernels --------------------------------------
+
+__attribute__((target("avx2")))
+static void orientationAvx2(float ax, float ay, float bx, float by,
+                            const float* cx, const float* cy, size_t n, int8_t* out) {
+    double dxs = static_cast<double>(bx) - ax, dys = static_cast<double>(by) - ay;
+    __m256d dx = _mm256_set1_pd(dxs), dy = _mm256_set1_pd(dys);
+    __m256d vax = _mm256_set1_pd(ax), vay = _mm256_set1_pd(ay), zero = _mm256_setzero_pd();
+    __m256d bound = _mm256_set1_pd(orientErrBound), absMask = _mm256_set1_pd(-0.0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d px = _mm256_cvtps_pd(_mm_loadu_ps(cx + i));
+        __m256d py = _mm256_cvtps_pd(_mm_loadu_ps(cy + i));
+        __m256d l = _mm256_mul_pd(dx, _mm256_sub_pd(py, vay));
+        __m256d r = _mm256_mul_pd(dy, _mm256_sub_pd(px, vax));
+        __m256d v = _mm256_sub_pd(l, r);
+        __m256d err = _mm256_mul_pd(bound, _mm256_add_pd(_mm256_andnot_pd(absMask, l),
+                                                         _mm256_andnot_pd(absMask, r)));
+        __m256d sure = _mm256_or_pd(_mm256_cmp_pd(_mm256_andnot_pd(absMask, v), err, _CMP_GT_OQ),
+                                    _mm256_or_pd(_mm256_cmp_pd(l, zero, _CMP_EQ_OQ),
+                                                 _mm256_cmp_pd(r, zero, _CMP_EQ_OQ)));
+        int gt = _mm256_movemask_pd(_mm256_cmp_pd(v, zero, _CMP_GT_OQ));
+        int lt = _mm256_movemask_pd(_mm256_cmp_pd(v, zero, _CMP_LT_OQ));
+        int unsure = ~_mm256_movemask_pd(sure) & 15;
+        for (int k = 0; k < 4; ++k)
+            out[i + k] = ((gt >> k) & 1) - ((lt >> k) & 1);
+        for (; unsure != 0; unsure &= unsure - 1) {
+            int k = __builtin_ctz(unsure);
+            out[i + k] = int8_t(orient2dExact(ax, ay, bx, by, cx[i + k], cy[i + k]));
+        }
+    }
+    orientationScalar(ax, ay, bx, by, cx + i, cy + i, n - i, out + i);
+}
+
+__attribute__((target("avx2")))
+static void leftOfAvx2(float ax, float ay, float bx, float by, double margin,
+                       const float* cx, const float* cy, size_t n, uint8_t* inside) {
+    double dxs = static_cast<double>(bx) - ax, dys = static_cast<double>(by) - ay;
+    __m256d dx = _mm256_set1_pd(dxs), dy = _mm256_set1_pd(dys);
+    __m256d vax = _mm256_set1_pd(ax), vay = _mm256_set1_pd(ay), m = _mm256_set1_pd(margin);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d px = _mm256_cvtps_pd(_mm_loadu_ps(cx + i));
+        __m256d py = _mm256_cvtps_pd(_mm_loadu_ps(cy + i));
+        __m256d v = _mm256_sub_pd(_mm256_mul_pd(dx, _mm256_sub_pd(py, vay)),
+                                  _mm256_mul_pd(dy, _mm256_sub_pd(px, vax)));
+        int left = _mm256_movemask_pd(_mm256_cmp_pd(v, m, _CMP_GT_OQ));
+        for (int k = 0; k < 4; ++k)
+            inside[i + k] &= (left >> k) & 1;
+    }
+    leftOfScalar(ax, ay, bx, by, margin, cx + i, cy + i, n - i, inside + i);
+}
+
+__attribute__((target("avx2")))
+static void orientationGridAvx2(int32_t ax, int32_t ay, int32_t bx, int32_t by,
+                                const int32_t* cx, const int32_t* cy, size_t n, int8_t* out) {
+    __m256i dx = _mm256_set1_epi32(bx - ax), dy = _mm256_set1_epi32(by - ay);
+    __m256i vax = _mm256_set1_epi32(ax), vay = _mm256_set1_epi32(ay), zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i px = _mm256_sub_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(cx + i)), vax);
+        __m256i py = _mm256_sub_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(cy + i)), vay);
+        for (int h = 0; h < 2; ++h) {
+            __m256i v = _mm256_sub_epi64(_mm256_mul_epi32(dx, py), _mm256_mul_epi32(dy, px));
+            int gt = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(v, zero)));
+            int lt = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(zero, v)));
+            for (int k = 0; k < 4; ++k)
+                out[i + 2 * k + h] = ((gt >> k) & 1) - ((lt >> k) & 1);
+            px = _mm256_srli_epi64(px, 32);
+            py = _mm256_srli_epi64(py, 32);
+        }
+    }
+    orientationGridScalar(ax, ay, bx, by, cx + i, cy + i, n - i, out + i);
+}
+
+__attribute__((target("avx2")))
+static double shoelaceAvx2(const float* x, const float* y, size_t n) {
+    __m256d acc = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 5 <= n; i += 4) {
+        __m256d xi = _mm256_cvtps_pd(_mm_loadu_ps(x + i));
+        __m256d yi = _mm256_cvtps_pd(_mm_loadu_ps(y + i));
+        __m256d xj = _mm256_cvtps_pd(_mm_loadu_ps(x + i + 1));
+        __m256d yj = _mm256_cvtps_pd(_mm_loadu_ps(y + i + 1));
+        acc = _mm256_add_pd(acc, _mm256_sub_pd(_mm256_mul_pd(xi, yj), _mm256_mul_pd(xj, yi)));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, acc);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + shoelaceTail(x, y, i, n);
+}
+
+__attribute__((target("avx2")))
+static void extremeValuesAvx2(const float* x, const float* y, size_t n, float best[8]) {
+    __m256 mn[4], mx[4];
+    for (int k = 0; k < 4; ++k) {
+        mn[k] = _mm256_set1_ps(best[minSlot[k]]);
+        mx[k] = _mm256_set1_ps(best[maxSlot[k]]);
+    }
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 vx = _mm256_loadu_ps(x + i), vy = _mm256_loadu_ps(y + i);
+        __m256 v[4] = {vx, _mm256_add_ps(vx, vy), vy, _mm256_sub_ps(vx, vy)};
+        for (int k = 0; k < 4; ++k) {
+            mn[k] = _mm256_min_ps(mn[k], v[k]);
+            mx[k] = _mm256_max_ps(mx[k], v[k]);
+        }
+    }
+    float lo[4][8], hi[4][8];
+    for (int k = 0; k < 4; ++k) {
+        _mm256_storeu_ps(lo[k], mn[k]);
+        _mm256_storeu_ps(hi[k], mx[k]);
+    }
+    for (int k = 0; k < 4; ++k) {
+        for (int l = 0; l < 8; ++l) {
+            best[minSlot[k]] = lo[k][l] < best[minSlot[k]] ? lo[k][l] : best[minSlot[k]];
+            best[maxSlot[k]] = hi[k][l] > best[maxSlot[k]] ? hi[k][l] : best[maxSlot[k]];
+        }
+    }
+    extremeValuesTail(x, y, i, n, best);
+}
+
+// Screens 8 points at a time for any extreme value; only blocks with a
+// hit go through the scalar check
+__attribute__((target("avx2")))
+static void extremeIndicesAvx2(const float* x, const float* y, size_t n,
+                               const float best[8], size_t idx[8]) {
+    bool found[8] = {false, false, false, false, false, false, false, false};
+    int missing = 8;
+    __m256 target[8];
+    for (int k = 0; k < 8; ++k)
+        target[k] = _mm256_set1_ps(best[k]);
+    size_t i = 0;
+    for (; i + 8 <= n && missing > 0; i += 8) {
+        __m256 vx = _mm256_loadu_ps(x + i), vy = _mm256_loadu_ps(y + i);
+        __m256 vs = _mm256_add_ps(vx, vy), vd = _mm256_sub_ps(vx, vy);
+        __m256 hit = _mm256_or_ps(
+            _mm256_or_ps(_mm256_or_ps(_mm256_cmp_ps(vx, target[0], _CMP_EQ_OQ),
+                                      _mm256_cmp_ps(vs, target[1], _CMP_EQ_OQ)),
+                         _mm256_or_ps(_mm256_cmp_ps(vy, target[2], _CMP_EQ_OQ),
+                                      _mm256_cmp_ps(vd, target[3], _CMP_EQ_OQ))),
+            _mm256_or_ps(_mm256_or_ps(_mm256_cmp_ps(vx, target[4], _CMP_EQ_OQ),
+                                      _mm256_cmp_ps(vs, target[5], _CMP_EQ_OQ)),
+                         _mm256_or_ps(_mm256_cmp_ps(vy, target[6], _CMP_EQ_OQ),
+                                      _mm256_cmp_ps(vd, target[7], _CMP_EQ_OQ))));
+        if (_mm256_movemask_ps(hit) != 0)
+            missing = extremeIndicesTail(x, y, i, i + 8, best, found, idx, missing);
+    }
+    extremeIndicesTail(x, y, i, n, best, found, idx, missing);
+}
+
+__attribute__((target("avx2")))
+static void pseudoAngleKeysAvx2(const float* x, const float* y, size_t n, float x0, float y0,
+                                uint64_t* keys) {
+    __m256d vx0 = _mm256_set1_pd(x0), vy0 = _mm256_set1_pd(y0), zero = _mm256_setzero_pd();
+    __m256d pivot = _mm256_set1_pd(-2.0), sign = _mm256_set1_pd(-0.0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d dx = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(x + i)), vx0);
+        __m256d dy = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(y + i)), vy0);
+        __m256d s = _mm256_add_pd(_mm256_andnot_pd(sign, dx), dy);
+        __m256d angle = _mm256_blendv_pd(pivot, _mm256_div_pd(dx, s), _mm256_cmp_pd(s, zero, _CMP_GT_OQ));
+        __m256d dist = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+        __m128i a = floatKeys(_mm256_cvtpd_ps(angle)), d = floatKeys(_mm256_cvtpd_ps(dist));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(keys + i), _mm_unpacklo_epi32(d, a));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(keys + i + 2), _mm_unpackhi_epi32(d, a));
+    }
+    pseudoAngleKeysScalar(x + i, y + i, n - i, x0, y0, keys + i);
+}
+
+__attribute__((target("avx2")))
+static void sortKeyLanesAvx2(uint64_t* keys, const KeyNetwork& net) {
+    const __m256i flip = _mm256_set1_epi64x(INT64_MIN);
+    for (size_t c = 0; c < net.size; ++c) {
+        __m256i* pa = reinterpret_cast<__m256i*>(keys + 4 * net.a[c]);
+        __m256i* pb = reinterpret_cast<__m256i*>(keys + 4 * net.b[c]);
+        __m256i a = _mm256_loadu_si256(pa), b = _mm256_loadu_si256(pb);
+        __m256i gt = _mm256_cmpgt_epi64(_mm256_xor_si256(a, flip), _mm256_xor_si256(b, flip));
+        _mm256_storeu_si256(pa, _mm256_blendv_epi8(a, b, gt));
+        _mm256_storeu_si256(pb, _mm256_blendv_epi8(b, a, gt));
+    }
+}
+
+#endif // HULL_SIMD_X86
+
+//------------------- Dispatch ------------------------------------------
+
+static SimdLevel detectSimdLevel() {
+#ifdef HULL_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse4.2"))
+        return SimdLevel::SSE42;
+#endif
+    return SimdLevel::Scalar;
+}
+
+static SimdLevel supportedLevel() {
+    static const SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+static std::atomic<int> forcedLevel(-1);
+
+SimdLevel simdLevel() {
+    int forced = forcedLevel.load(std::memory_order_relaxed);
+    return forced < 0 ? supportedLevel() : static_cast<SimdLevel>(forced);
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::SSE42: return "sse4.2";
+        case SimdLevel::Scalar:
+        default: return "scalar";
+    }
+}
+
+SimdLevel setSimdLevel(SimdLevel level) {
+    if (static_cast<int>(level) > static_cast<int>(supportedLevel()))
+        level = supportedLevel();
+    forcedLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+    return level;
+}
+
+void orientationBatch(float ax, float ay, float bx, float by,
+                      const float* cx, const float* cy, size_t n, int8_t* out) {
+    switch (simdLevel()) {
+#ifdef HULL_SIMD_X86
+        case SimdLevel::AVX2: orientationAvx2(ax, ay, bx, by, cx, cy, n, out); return;
+        case SimdLevel::SSE42: orientationSse42(ax, ay, bx, by, cx, cy, n, out); return;
+#endif
+        default: orientationScalar(ax, ay, bx, by, cx, cy, n, out); return;
+    }
+}
+
+void leftOfBatch(float ax, float ay, float bx, float by, double margin,
+                 const float* cx, const float* cy, size_t n, uint8_t* inside) {
+    switch (simdLevel()) {
+#ifdef HULL_SIMD_X86
+        case SimdLevel::AVX2: leftOfAvx2(ax, ay, bx, by, margin, cx, cy, n, inside); return;
+        case SimdLevel::SSE42: leftOfSse42(ax, ay, bx, by, margin, cx, cy, n, inside); return;
+#endif
+        default: leftOfScalar(ax, ay, bx, by, margin, cx, cy, n, inside); return;
+    }
+}
+
+void orientationBatchGrid(int32_t ax, int32_t ay, int32_t bx, int32_t by,
+                          const int32_t* cx, const int32_t* cy, size_t n, int8_t* out) {
+    switch (simdLevel()) {
+#ifdef HULL_SIMD_X86
+        case SimdLevel::AVX2: orientationGridAvx2(ax, ay, bx, by, cx, cy, n, out); return;
+        case SimdLevel::SSE42: orientationGridSse42(ax, ay, bx, by, cx, cy, n, out); return;
+#endif
+        default: orientationGridScalar(ax, ay, bx, by, cx, cy, n, out); return;
+    }
+}
+
+double shoelaceSum(const float* x, const float* y, size_t n) {
+    if (n < 3) return 0.0;
+    switch (simdLevel()) {
+#ifdef HULL_SIMD_X86
+        case SimdLevel::AVX2: return shoelaceAvx2(x, y, n);
+        case SimdLevel::SSE42: return shoelaceSse42(x, y, n);
+#endif
+        default: return shoelaceTail(x, y, 0, n);
+    }
+}
+
+void extremePoints(const float* x, const float* y, size_t n, size_t idx[8]) {
+    for (int k = 0; k < 8; ++k)
+        idx[k] = 0;
+    if (n == 0) return;
+
+    // Pass 1: extreme values, vectorized
+    float best[8] = {x[0], x[0] + y[0], y[0], x[0] - y[0], x[0], x[0] + y[0], y[0], x[0] - y[0]};
+    switch (simdLevel()) {
+#ifdef HULL_SIMD_X86
+        case SimdLevel::AVX2: extremeValuesAvx2(x, y, n, best); break;
+        case SimdLevel::SSE42: extremeValuesSse42(x, y, n, best); break;
+#endif
+        default: extremeValuesTail(x, y, 1, n, best); break;
+    }
+
+    // Pass 2: first index reaching each value, stopping once all are found
+    bool found[8] = {false, false, false, false, false, false, false, false};
+    switch (simdLevel()) {
+#ifdef HULL_SIMD_X86
+        case SimdLevel::AVX2: extremeIndicesAvx2(x, y, n, best, idx); break;
+#endif
+        default: extremeIndicesTail(x, y, 0, n, best, found, idx, 8); break;
+    }
+}
+
+void pseudoAngleKeys(const float* x, const float* y, size_t n, float x0, float y0, uint64_t* keys) {
+    switch (simdLevel()) {
+#ifdef HULL_SIMD_X86
+        case SimdLevel::AVX2: pseudoAngleKeysAvx2(x, y, n, x0, y0, keys); return;
+        case SimdLevel::SSE42: pseudoAngleKeysSse42(x, y, n, x0, y0, keys); return;
+#endif
+        default: pseudoAngleKeysScalar(x, y, n, x0, y0, keys); return;
+    }
+}
+
+void sortKeyLanes(uint64_t* keys, size_t n) {
+    const KeyNetwork& net = keyNetwork(n < 16 ? n : 16);
+    switch (simdLevel()) {
+#ifdef HULL_SIMD_X86
+        case SimdLevel::AVX2: sortKeyLanesAvx2(keys, net); return;
+        case SimdLevel::SSE42: sortKeyLanesSse42(keys, net); return;
+#endif
+        default: sortKeyLanesScalar(keys, net); return;
+    }
+}
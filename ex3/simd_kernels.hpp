@@ -0,0 +1,62 @@
+#ifndef SIMD_KERNELS_HPP
+#define SIMD_KERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Batched geometry kernels over SoA coordinates. Each call dispatches to
+// AVX2, SSE4.2 or scalar code, picked once from the CPU's feature flags.
+// Orientation and extreme results are identical at every level; shoelace
+// sums differ only in rounding from the summation order.
+
+enum class SimdLevel { Scalar, SSE42, AVX2 };
+
+// Level the kernels currently run at
+SimdLevel simdLevel();
+const char* simdLevelName(SimdLevel level);
+
+// Forces a lower level (for benchmarks); clamped to what the CPU supports.
+// Returns the level actually selected.
+SimdLevel setSimdLevel(SimdLevel level);
+
+// out[i] = orientation of (a, b, c_i): +1 counterclockwise, -1 clockwise,
+// 0 collinear. Exact: the double cross product (b - a) x (c_i - a) decides
+// unless it is within orient2d's error bound, and orient2dExact() settles
+// those points.
+void orientationBatch(float ax, float ay, float bx, float by,
+                      const float* cx, const float* cy, size_t n, int8_t* out);
+
+// inside[i] stays set only while (b - a) x (c_i - a) > margin, evaluated
+// in double, so a polygon's edges can be applied one after another. With
+// margin at least the rounding error of the product, a point that stays
+// set is strictly left of a->b.
+void leftOfBatch(float ax, float ay, float bx, float by, double margin,
+                 const float* cx, const float* cy, size_t n, uint8_t* inside);
+
+// orientationBatch over integer coordinates, exact: the cross product is
+// formed from 32-bit differences as 64-bit products. Every coordinate
+// must lie within +-(2^30 - 1) so the differences fit in 32 bits.
+void orientationBatchGrid(int32_t ax, int32_t ay, int32_t bx, int32_t by,
+                          const int32_t* cx, const int32_t* cy, size_t n, int8_t* out);
+
+// Twice the signed area of the closed polygon (x[i], y[i]), in double
+double shoelaceSum(const float* x, const float* y, size_t n);
+
+// Indices of the first point reaching each extreme, counterclockwise:
+// min x, min x+y, min y, max x-y, max x, max x+y, max y, min x-y
+void extremePoints(const float* x, const float* y, size_t n, size_t idx[8]);
+
+// Graham sort keys around the pivot (x0, y0), the lowest (then leftmost)
+// point: the high half is the pseudo-angle dx / (|dx| + dy), falling from
+// 1 to -1 as the angle grows from 0 to pi, the low half the squared
+// distance, both as packKeys() floats; the pivot's copies get angle -2.
+// Computed in double and rounded once, so every angle is within 2^-25 of
+// the exact one; identical at every level.
+void pseudoAngleKeys(const float* x, const float* y, size_t n, float x0, float y0, uint64_t* keys);
+
+// Sorts four interleaved sets of n <= 16 keys, each on its own: key i of
+// set s is keys[4 * i + s]. Same compares as the tiny_hull.hpp network,
+// two or four sets per instruction on SSE4.2 and AVX2.
+void sortKeyLanes(uint64_t* keys, size_t n);
+
+#endif
@@ -0,0 +1,68 @@
+#include "socket_io.hpp"
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+
+bool readFully(int fd, char* dst, size_t n) {
+    while (n > 0) {
+        ssize_t got = read(fd, dst, n);
+        if (got <= 0) return false;
+        dst += got;
+        n -= size_t(got);
+    }
+    return true;
+}
+
+bool sendFully(int fd, const char* src, size_t n) {
+    while (n > 0) {
+        ssize_t sent = send(fd, src, n, 0);
+        if (sent <= 0) return false;
+        src += sent;
+        n -= size_t(sent);
+    }
+    return true;
+}
+
+int readLine(int fd, std::string& pending, std::string& line) {
+    size_t newline;
+    while ((newline = pending.find('\n')) == std::string::npos && pending.size() <= maxCommandLine) {
+        char chunk[4096];
+        ssize_t got = read(fd, chunk, sizeof(chunk));
+        if (got < 0) return -1;
+        if (got == 0) {
+            if (pending.empty()) return 0;
+            line.swap(pending);
+            pending.clear();
+            return 1;
+        }
+        pending.append(chunk, size_t(got));
+    }
+    if (newline == std::string::npos || newline > maxCommandLine) {
+        line.assign(pending, 0, maxCommandLine);
+        pending.erase(0, maxCommandLine);
+    } else {
+        line.assign(pending, 0, newline);
+        pending.erase(0, newline + 1);
+    }
+    return 1;
+}
+
+bool serveBulk(int fd, const std::string& header, std::string& pending, BatchHull& batch) {
+    BulkRequest request;
+    if (!request.parseHeader(header.c_str())) {
+        const char* error = "Invalid format. Use: Bulk sets points, then the binary payload\n";
+        sendFully(fd, error, strlen(error));
+        return false;
+    }
+    size_t have = std::min(pending.size(), request.payloadSize());
+    memcpy(request.payload(), pending.data(), have);
+    pending.erase(0, have);
+    if (!readFully(fd, request.payload() + have, request.payloadSize() - have))
+        return false;
+
+    std::string reply;
+    request.solve(batch, reply);
+    return sendFully(fd, reply.data(), reply.size());
+}
@@ -0,0 +1,35 @@
+#ifndef SOCKET_IO_HPP
+#define SOCKET_IO_HPP
+
+#include <cstddef>
+#include <string>
+#include "batch_hull.hpp"
+
+// Blocking framing over a connected socket, shared by the servers: whole
+// buffers, '\n'-terminated command lines and the Bulk request described in
+// batch_hull.hpp. pending holds the bytes read but not consumed yet, so
+// commands pipelined behind one another, or behind a Bulk payload, are
+// taken one at a time.
+
+// Loop until all n bytes are moved; false once the connection is closed
+// or fails
+bool readFully(int fd, char* dst, size_t n);
+bool sendFully(int fd, const char* src, size_t n);
+
+// Longest command line; a longer one is cut into lines of this length
+const size_t maxCommandLine = 255;
+
+// Moves the next line of pending to line, without its '\n', reading more
+// as needed. Returns 1 with a line, 0 once the peer closed the connection
+// and -1 on an error, with errno set, as read() does. A last line without
+// '\n' is returned when the peer closes.
+int readLine(int fd, std::string& pending, std::string& line);
+
+// Answers a Bulk request whose header line was just taken off pending:
+// reads the payload, from pending first, and sends the reply. False once
+// the connection is lost, and after a malformed header has been answered
+// with an error line: the payload size is then unknown, so nothing after
+// it can be found and the connection has to be closed.
+bool serveBulk(int fd, const std::string& header, std::string& pending, BatchHull& batch);
+
+#endif
@@ -0,0 +1,93 @@
+#include "stream_hull.hpp"
+#include "hull_core.hpp"
+#include "simd_kernels.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <future>
+
+typedef BasicConvexHull<float, Point> HullCore;
+
+size_t TextPointSource::read(Point* dst, size_t max) {
+    size_t count = 0;
+    const char* line;
+    const char* end;
+    while (count < max && lines.next(line, end)) {
+        float x, y;
+        if (scanFloat(line, end, x) && scanFloat(line, end, y))
+            dst[count++] = Point(x, y);
+    }
+    return count;
+}
+
+// The chunk's hull, or its extremes if it is degenerate, merged into the
+// running hull
+void StreamHull::absorb(const Point* pts, size_t n) {
+    chunkHull.findConvexHull(pts, n);
+    std::vector<Point> part = chunkHull.getConvexHullPoints();
+    if (part.empty()) {
+        auto ends = std::minmax_element(pts, pts + n, HullCore::lessXY);
+        part.push_back(*ends.first);
+        if (!HullCore::same(*ends.first, *ends.second))
+            part.push_back(*ends.second);
+    }
+
+    if (!hull.empty()) {
+        hull = ConvexHull::mergeHulls(hull, part);
+        return;
+    }
+
+    // Everything so far collinear: the hull of both spans, or a wider span
+    span.insert(span.end(), part.begin(), part.end());
+    std::vector<Point> merged;
+    HullCore::monotone(span.data(), span.data() + span.size(), merged);
+    if (merged.size() >= 3) {
+        hull.swap(merged);
+        span.clear();
+        return;
+    }
+    auto ends = std::minmax_element(span.begin(), span.end(), HullCore::lessXY);
+    Point lo = *ends.first, hi = *ends.second;
+    span.assign({lo, hi});
+}
+
+bool StreamHull::run(PointSource& source) {
+    hull.clear();
+    span.clear();
+    stats = Stats();
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<Point> current(chunkPoints), next(chunkPoints);
+    size_t n = source.read(current.data(), chunkPoints);
+    while (n > 0) {
+        // Double buffering: the reader fills next while current is hulled
+        std::future<size_t> pending = std::async(std::launch::async, [&]() {
+            return source.read(next.data(), chunkPoints);
+        });
+        absorb(current.data(), n);
+        stats.points += n;
+        ++stats.chunks;
+
+        auto waitStart = std::chrono::steady_clock::now();
+        n = pending.get();
+        auto waitEnd = std::chrono::steady_clock::now();
+        stats.readWaitSeconds += std::chrono::duration<double>(waitEnd - waitStart).count();
+        current.swap(next);
+    }
+
+    stats.bytes = source.bytesRead();
+    stats.seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return !source.failed();
+}
+
+double StreamHull::area() const {
+    std::vector<float> xs, ys;
+    xs.reserve(hull.size());
+    ys.reserve(hull.size());
+    for (const auto& p : hull) {
+        xs.push_back(p.getX());
+        ys.push_back(p.getY());
+    }
+    return std::abs(shoelaceSum(xs.data(), ys.data(), hull.size())) / 2.0;
+}
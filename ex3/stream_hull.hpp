@@ -0,0 +1,80 @@
+#ifndef STREAM_HULL_HPP
+#define STREAM_HULL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "convex_hull.hpp"
+#include "line_reader.hpp"
+#include "point.hpp"
+
+// Where StreamHull gets its points from, one chunk at a time
+class PointSource {
+public:
+    virtual ~PointSource() {}
+
+    // Up to max points into dst; 0 once the input is exhausted
+    virtual size_t read(Point* dst, size_t max) = 0;
+    virtual uint64_t bytesRead() const = 0;
+    virtual bool failed() const = 0;
+};
+
+// Text points, one "x y" per line; lines that do not start with two
+// numbers are skipped. Reads the file in large blocks.
+class TextPointSource : public PointSource {
+public:
+    explicit TextPointSource(std::FILE* in, size_t blockBytes = 1 << 20) : lines(in, blockBytes) {}
+
+    size_t read(Point* dst, size_t max) override;
+    uint64_t bytesRead() const override { return lines.bytesRead(); }
+    bool failed() const override { return lines.failed(); }
+
+private:
+    LineReader lines;
+};
+
+// Hull of a point stream too large to hold in memory. Points are read in
+// chunks of chunkPoints; each chunk is hulled by ConvexHull over the
+// buffer and merged into the running hull with mergeHulls(), so memory
+// stays at two chunk buffers plus the hull. A reader thread fills one
+// buffer while the other is hulled.
+class StreamHull {
+public:
+    struct Stats {
+        uint64_t points = 0;
+        uint64_t chunks = 0;
+        uint64_t bytes = 0;
+        double seconds = 0.0;
+        double readWaitSeconds = 0.0; // hulling stalled on the reader
+        double pointsPerSecond() const { return seconds > 0.0 ? points / seconds : 0.0; }
+    };
+
+    explicit StreamHull(size_t chunkPoints = 1 << 20) : chunkPoints(chunkPoints) {}
+
+    // Engine and prefilter for the chunk hulls (ConvexHull defaults)
+    void setAlgorithm(ConvexHull::Algorithm algorithm) { chunkHull.setAlgorithm(algorithm); }
+    void setPrefilter(bool enabled) { chunkHull.setPrefilter(enabled); }
+
+    // Hull of everything source yields; false if it failed part way, in
+    // which case the hull covers the points read until then
+    bool run(PointSource& source);
+
+    // Clockwise from the pivot, empty for fewer than 3 hull vertices
+    const std::vector<Point>& getHull() const { return hull; }
+    double area() const;
+    const Stats& getStats() const { return stats; }
+
+private:
+    size_t chunkPoints;
+    ConvexHull chunkHull;
+    std::vector<Point> hull;
+    // While every point so far is collinear, the least and greatest of
+    // them by (x, y); empty once hull holds a proper hull
+    std::vector<Point> span;
+    Stats stats;
+
+    void absorb(const Point* pts, size_t n);
+};
+
+#endif
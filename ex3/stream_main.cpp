@@ -0,0 +1,44 @@
+// Hull of a point file of any size, read in chunks
+// Usage: ./convex_hull_stream [file|-] [chunk points]
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "stream_hull.hpp"
+
+int main(int argc, char* argv[]) {
+    const char* path = argc > 1 ? argv[1] : "-";
+    long chunk = argc > 2 ? std::atol(argv[2]) : 1 << 20;
+    if (argc > 3 || chunk < 3) {
+        fprintf(stderr, "Usage: %s [file|-] [chunk points]\n", argv[0]);
+        return 1;
+    }
+
+    std::FILE* in = strcmp(path, "-") == 0 ? stdin : std::fopen(path, "rb");
+    if (in == nullptr) {
+        perror(path);
+        return 1;
+    }
+
+    TextPointSource source(in);
+    StreamHull stream(static_cast<size_t>(chunk));
+    stream.setAlgorithm(ConvexHull::Algorithm::Auto);
+    bool ok = stream.run(source);
+    if (in != stdin)
+        std::fclose(in);
+
+    const std::vector<Point>& hull = stream.getHull();
+    printf("Convex Hull (%zu points):\n", hull.size());
+    for (const auto& p : hull)
+        printf("(%.2f, %.2f)\n", p.getX(), p.getY());
+    printf("Area: %.2f\n", stream.area());
+
+    const StreamHull::Stats& stats = stream.getStats();
+    fprintf(stderr, "%llu points in %llu chunks, %.1f MB in %.3f s: %.2f Mpoints/s (%.3f s waiting on reads)\n",
+            (unsigned long long)stats.points, (unsigned long long)stats.chunks, stats.bytes / 1e6,
+            stats.seconds, stats.pointsPerSecond() / 1e6, stats.readWaitSeconds);
+    if (!ok) {
+        fprintf(stderr, "%s: read error\n", path);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <utility>
+
+ThreadPool::ThreadPool(unsigned threads) {
+    for (unsigned i = 1; i < threads; ++i)
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    for (auto& t : workers)
+        t.join();
+}
+
+void ThreadPool::submit(TaskGroup& group, std::function<void()> task) {
+    group.pending.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back({std::move(task), &group});
+    }
+    changed.notify_one();
+}
+
+// Pops and runs one task with the lock released; false if the queue is empty
+bool ThreadPool::runOne(std::unique_lock<std::mutex>& lock) {
+    if (queue.empty()) return false;
+    Task task = std::move(queue.back());
+    queue.pop_back();
+    lock.unlock();
+    task.run();
+    lock.lock();
+    task.group->pending.fetch_sub(1);
+    changed.notify_all();
+    return true;
+}
+
+void ThreadPool::wait(TaskGroup& group) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (group.pending.load() > 0) {
+        if (!runOne(lock))
+            changed.wait(lock);
+    }
+}
+
+void ThreadPool::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        if (!runOne(lock))
+            changed.wait(lock);
+    }
+}
+
+void ThreadPool::parallelFor(size_t n, size_t chunks,
+                             const std::function<void(size_t, size_t, size_t)>& body) {
+    chunks = std::max<size_t>(1, std::min(chunks, n));
+    size_t step = (n + chunks - 1) / chunks;
+    TaskGroup group;
+    for (size_t c = 1; c < chunks && c * step < n; ++c) {
+        size_t begin = c * step, end = std::min(n, begin + step);
+        submit(group, [&body, c, begin, end]() { body(c, begin, end); });
+    }
+    body(0, 0, std::min(n, step));
+    wait(group);
+}
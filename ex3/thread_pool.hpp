@@ -0,0 +1,58 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool for fork/join work. A thread waiting on a TaskGroup runs
+// queued tasks itself, so tasks may spawn and wait on nested groups.
+class ThreadPool {
+public:
+    // Outstanding tasks submitted under one join point
+    class TaskGroup {
+    public:
+        TaskGroup() : pending(0) {}
+    private:
+        std::atomic<int> pending;
+        friend class ThreadPool;
+    };
+
+    // threads counts the caller, so ThreadPool(1) starts no workers
+    explicit ThreadPool(unsigned threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return workers.size() + 1; }
+
+    void submit(TaskGroup& group, std::function<void()> task);
+    void wait(TaskGroup& group);
+
+    // Runs body(chunk, begin, end) over [0, n) split into chunks, and waits
+    void parallelFor(size_t n, size_t chunks,
+                     const std::function<void(size_t, size_t, size_t)>& body);
+
+private:
+    struct Task {
+        std::function<void()> run;
+        TaskGroup* group;
+    };
+
+    std::vector<std::thread> workers;
+    std::deque<Task> queue;
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool stopping = false;
+
+    bool runOne(std::unique_lock<std::mutex>& lock);
+    void workerLoop();
+};
+
+#endif
@@ -0,0 +1,173 @@
+#ifndef TINY_HULL_HPP
+#define TINY_HULL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "point.hpp"
+#include "predicates.hpp"
+#include "radix_sort.hpp"
+
+// Hull kernels for inputs of at most tinyHullMax points. Points are packed
+// into packKeys(x, y) keys and sorted by a Batcher merge-exchange network:
+// with N known at compile time the network unrolls into a straight run of
+// 64-bit min/max pairs, with no branches and no comparator calls. The
+// monotone chain then runs on stack arrays, so a hull allocates nothing
+// once out has grown. Results follow the chPoints contract.
+
+const size_t tinyHullMax = 16;
+
+__attribute__((always_inline)) inline void compareExchange(uint64_t& a, uint64_t& b) {
+    uint64_t lo = a < b ? a : b;
+    uint64_t hi = a < b ? b : a;
+    a = lo;
+    b = hi;
+}
+
+// Batcher's merge exchange for any N, written out by the compiler: for p
+// = 1, 2, 4, ... merge sorted runs of p keys pairwise, comparing keys s =
+// p, p/2, ..., 1 apart that fall in the same run of 2p. Each level below
+// is one loop of that nest, ended by its false specialization; forced
+// inline, since past a few dozen pairs GCC would otherwise stop unrolling.
+template <size_t N, size_t P, size_t S, size_t J, size_t I, bool = (I < S && I + J + S < N)>
+struct MergeExchangeI {
+    __attribute__((always_inline)) static void apply(uint64_t* keys) {
+        if ((I + J) / (2 * P) == (I + J + S) / (2 * P))
+            compareExchange(keys[I + J], keys[I + J + S]);
+        MergeExchangeI<N, P, S, J, I + 1>::apply(keys);
+    }
+};
+template <size_t N, size_t P, size_t S, size_t J, size_t I>
+struct MergeExchangeI<N, P, S, J, I, false> {
+    static void apply(uint64_t*) {}
+};
+
+template <size_t N, size_t P, size_t S, size_t J, bool = (J + S < N)>
+struct MergeExchangeJ {
+    __attribute__((always_inline)) static void apply(uint64_t* keys) {
+        MergeExchangeI<N, P, S, J, 0>::apply(keys);
+        MergeExchangeJ<N, P, S, J + 2 * S>::apply(keys);
+    }
+};
+template <size_t N, size_t P, size_t S, size_t J>
+struct MergeExchangeJ<N, P, S, J, false> {
+    static void apply(uint64_t*) {}
+};
+
+template <size_t N, size_t P, size_t S, bool = (S > 0)>
+struct MergeExchangeS {
+    __attribute__((always_inline)) static void apply(uint64_t* keys) {
+        MergeExchangeJ<N, P, S, S % P>::apply(keys);
+        MergeExchangeS<N, P, S / 2>::apply(keys);
+    }
+};
+template <size_t N, size_t P, size_t S>
+struct MergeExchangeS<N, P, S, false> {
+    static void apply(uint64_t*) {}
+};
+
+template <size_t N, size_t P = 1, bool = (P < N)>
+struct MergeExchange {
+    __attribute__((always_inline)) static void apply(uint64_t* keys) {
+        MergeExchangeS<N, P, P>::apply(keys);
+        MergeExchange<N, 2 * P>::apply(keys);
+    }
+};
+template <size_t N, size_t P>
+struct MergeExchange<N, P, false> {
+    static void apply(uint64_t*) {}
+};
+
+// Clockwise hull of n <= tinyHullMax keys sorted ascending, from the
+// pivot, into hx and hy; returns the vertex count, 0 below 3 vertices
+inline size_t tinyChain(const uint64_t* keys, size_t n, float* hx, float* hy) {
+    if (n < 3) return 0;
+    float x[tinyHullMax], y[tinyHullMax];
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = keyFloat(uint32_t(keys[i] >> 32));
+        y[i] = keyFloat(uint32_t(keys[i]));
+    }
+
+    // Keep right turns only: upper chain left to right, then lower chain back
+    uint8_t h[2 * tinyHullMax];
+    size_t k = 0;
+    for (size_t i = 0; i < n; ++i) {
+        while (k >= 2 && orient2d(x[h[k - 2]], y[h[k - 2]], x[h[k - 1]], y[h[k - 1]], x[i], y[i]) >= 0)
+            --k;
+        h[k++] = uint8_t(i);
+    }
+    for (size_t i = n - 1, upper = k + 1; i-- > 0;) {
+        while (k >= upper && orient2d(x[h[k - 2]], y[h[k - 2]], x[h[k - 1]], y[h[k - 1]], x[i], y[i]) >= 0)
+            --k;
+        h[k++] = uint8_t(i);
+    }
+    --k; // last point repeats the first
+    if (k < 3) return 0;
+
+    // Clockwise from the leftmost point; start at the pivot instead
+    size_t pivot = 0;
+    for (size_t i = 1; i < k; ++i) {
+        float py = y[h[pivot]], qy = y[h[i]];
+        if (qy < py || (qy == py && x[h[i]] < x[h[pivot]]))
+            pivot = i;
+    }
+    for (size_t i = 0; i < k; ++i) {
+        size_t v = h[pivot + i < k ? pivot + i : pivot + i - k];
+        hx[i] = x[v];
+        hy[i] = y[v];
+    }
+    return k;
+}
+
+// MergeExchange<n> over n <= tinyHullMax keys
+inline void tinySort(uint64_t* keys, size_t n) {
+    switch (n) {
+        case 2: MergeExchange<2>::apply(keys); return;
+        case 3: MergeExchange<3>::apply(keys); return;
+        case 4: MergeExchange<4>::apply(keys); return;
+        case 5: MergeExchange<5>::apply(keys); return;
+        case 6: MergeExchange<6>::apply(keys); return;
+        case 7: MergeExchange<7>::apply(keys); return;
+        case 8: MergeExchange<8>::apply(keys); return;
+        case 9: MergeExchange<9>::apply(keys); return;
+        case 10: MergeExchange<10>::apply(keys); return;
+        case 11: MergeExchange<11>::apply(keys); return;
+        case 12: MergeExchange<12>::apply(keys); return;
+        case 13: MergeExchange<13>::apply(keys); return;
+        case 14: MergeExchange<14>::apply(keys); return;
+        case 15: MergeExchange<15>::apply(keys); return;
+        case 16: MergeExchange<16>::apply(keys); return;
+        default: return;
+    }
+}
+
+// Hull of n <= tinyHullMax points given as packKeys(x, y) keys, which are
+// sorted in place
+inline size_t tinyHull(uint64_t* keys, size_t n, float* hx, float* hy) {
+    tinySort(keys, n);
+    return tinyChain(keys, n, hx, hy);
+}
+
+inline void tinyHull(uint64_t* keys, size_t n, std::vector<Point>& out) {
+    float hx[tinyHullMax], hy[tinyHullMax];
+    size_t k = tinyHull(keys, n, hx, hy);
+    out.clear();
+    for (size_t i = 0; i < k; ++i)
+        out.push_back(Point(hx[i], hy[i]));
+}
+
+inline void tinyHull(const Point* pts, size_t n, std::vector<Point>& out) {
+    uint64_t keys[tinyHullMax];
+    for (size_t i = 0; i < n; ++i)
+        keys[i] = packKeys(pts[i].getX(), pts[i].getY());
+    tinyHull(keys, n, out);
+}
+
+inline void tinyHull(const float* xs, const float* ys, size_t n, std::vector<Point>& out) {
+    uint64_t keys[tinyHullMax];
+    for (size_t i = 0; i < n; ++i)
+        keys[i] = packKeys(xs[i], ys[i]);
+    tinyHull(keys, n, out);
+}
+
+#endif
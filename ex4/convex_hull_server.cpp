@@ -10,10 +10,17 @@
 #include <unistd.h>
 #include <algorithm>
 #include <cmath>
+#include <memory>
+#include <string>
 #include <vector>
 #include <iostream>
+#include "../ex3/arena.hpp"
 #include "../ex3/convex_hull.hpp"
+#include "../ex3/engine_selector.hpp"
+#include "../ex3/hull_cache.hpp"
 #include "../ex3/point.hpp"
+#include "../ex3/point_file.hpp"
+#include "../ex3/point_soa.hpp"
 
 #define BACKLOG 10
 #define MAX_CLIENTS 12
@@ -31,68 +38,126 @@ void handle_sigint(int sig)
 
 //------------------- Graph functions ------------------------------------
 
-// Global shared graph and convex hull object
+// Global shared graph, the only copy of the points; ch runs over it as a view
 std::vector<Point> shared_points;
-ConvexHull* ch = nullptr;
+std::unique_ptr<PointFile> loaded_points; // a Loadgraph file, the graph until it is edited
+ConvexHull ch;
+uint64_t graph_version = 0; // bumped by every change to the graph
+HullCache hull_cache;
+std::string data_dir; // --data-dir, where Loadgraph finds point files
+
+// A loaded file stays mapped and is hulled where it lies until the first
+// Newpoint or Removepoint, which copies it into shared_points
+void materializeLoadedGraph() {
+    if (!loaded_points) return;
+    soaToPoints(loaded_points->xData(), loaded_points->yData(), loaded_points->size(), shared_points);
+    loaded_points.reset();
+}
+
+size_t graphSize() {
+    return loaded_points ? loaded_points->size() : shared_points.size();
+}
 
 void initializeGraph() {
-    if (ch != nullptr) {
-        delete ch;
-    }
+    loaded_points.reset();
     shared_points.clear();
-    ch = new ConvexHull(shared_points);
+    ++graph_version;
     printf("New graph initialized\n");
 }
 
 void addPointToGraph(float x, float y) {
+    materializeLoadedGraph();
+    // A point inside the cached hull or on its boundary cannot change it
+    bool inside = hull_cache.contains(graph_version, x, y);
     shared_points.emplace_back(x, y);
-    if (ch != nullptr) {
-        delete ch;
+    ++graph_version;
+    if (inside && hull_cache.carry(graph_version - 1, graph_version)) {
+        printf("Point is inside the hull, cached hull kept (%llu recomputes avoided)\n",
+               (unsigned long long)hull_cache.getAvoidedRecomputes());
     }
-    ch = new ConvexHull(shared_points);
     printf("Added point (%.2f, %.2f). Total points: %zu\n", x, y, shared_points.size());
 }
 
 void removePointFromGraph(float x, float y) {
+    materializeLoadedGraph();
     Point targetPoint(x, y);
+    // The hull survives unless one of the removed points is its vertex;
+    // each is checked before remove_if overwrites it
+    bool hull_kept = true;
     auto it = std::remove_if(shared_points.begin(), shared_points.end(),
-        [&targetPoint](const Point& p) {
-            return std::abs(p.getX() - targetPoint.getX()) < 0.001f && 
-                   std::abs(p.getY() - targetPoint.getY()) < 0.001f;
+        [&targetPoint, &hull_kept](const Point& p) {
+            bool match = std::abs(p.getX() - targetPoint.getX()) < 0.001f && 
+                         std::abs(p.getY() - targetPoint.getY()) < 0.001f;
+            if (match && hull_cache.isVertex(graph_version, p.getX(), p.getY()))
+                hull_kept = false;
+            return match;
         });
     
     if (it != shared_points.end()) {
         shared_points.erase(it, shared_points.end());
-        if (ch != nullptr) {
-            delete ch;
+        ++graph_version;
+        if (hull_kept && hull_cache.carry(graph_version - 1, graph_version)) {
+            printf("No hull vertex removed, cached hull kept (%llu recomputes avoided)\n",
+                   (unsigned long long)hull_cache.getAvoidedRecomputes());
         }
-        ch = new ConvexHull(shared_points);
         printf("Removed point (%.2f, %.2f). Total points: %zu\n", x, y, shared_points.size());
     } else {
         printf("Point (%.2f, %.2f) not found\n", x, y);
     }
 }
 
-void computeConvexHull() {
-    if (shared_points.size() < 3) {
-        printf("Need at least 3 points to compute convex hull\n");
-        return;
+// Loadgraph name: replaces the graph with the point file (point_file.hpp)
+// of that name under data_dir. The file is mapped, not parsed; see
+// materializeLoadedGraph().
+std::string loadGraph(const char* name) {
+    std::string path, error;
+    if (!resolvePointFilePath(data_dir, name, path, error))
+        return std::string("Cannot load ") + name + ": " + error + "\n";
+    std::unique_ptr<PointFile> file(new PointFile);
+    if (!file->open(path.c_str()))
+        return std::string("Cannot load ") + name + ": " + file->error() + "\n";
+
+    shared_points.clear();
+    loaded_points = std::move(file);
+    ++graph_version;
+    const PointFileHeader& h = loaded_points->header();
+    printf("Loaded %zu points from %s, bounds (%.2f, %.2f) - (%.2f, %.2f)\n", loaded_points->size(),
+           path.c_str(), h.minX, h.minY, h.maxX, h.maxY);
+    return "Graph loaded with " + std::to_string(loaded_points->size()) + " points\n";
+}
+
+// Hull, area and reply for the current graph; only the first CH after a
+// change recomputes, later ones reuse the cached snapshot
+HullCache::Snapshot computeConvexHull() {
+    HullCache::Snapshot hull = hull_cache.lookup(graph_version);
+    if (hull) {
+        printf("Convex hull unchanged (%zu points)\n", hull->hull.size());
+        return hull;
     }
     
-    if (ch != nullptr) {
-        ch->findConvexHull();
-        std::vector<Point> hull_points = ch->getConvexHullPoints();
-        printf("Computed convex hull with %zu points:\n", hull_points.size());
-        for (const auto& p : hull_points) {
-            printf("  (%.2f, %.2f)\n", p.getX(), p.getY());
-        }
-        double area = ch->polygonArea();
-        printf("Hull area: %.2f\n", area);
+    if (loaded_points)
+        ch.findConvexHull(loaded_points->xData(), loaded_points->yData(), loaded_points->size());
+    else
+        ch.findConvexHull(shared_points.data(), shared_points.size());
+    const std::vector<Point>& hull_points = ch.getConvexHullPoints();
+    printf("Computed convex hull with %zu points:\n", hull_points.size());
+    for (const auto& p : hull_points) {
+        printf("  (%.2f, %.2f)\n", p.getX(), p.getY());
     }
+    double area = ch.polygonArea();
+    printf("Hull area: %.2f\n", area);
+    return hull_cache.store(graph_version, hull_points, area);
 }
 
 void printCurrentGraph() {
-    printf("Current graph has %zu points:\n", shared_points.size());
+    printf("Current graph has %zu points:\n", graphSize());
+    if (loaded_points) {
+        const float* xs = loaded_points->xData();
+        const float* ys = loaded_points->yData();
+        for (size_t i = 0; i < loaded_points->size(); ++i)
+            printf("  %zu: (%.2f, %.2f)\n", i+1, xs[i], ys[i]);
+        return;
+    }
     for (size_t i = 0; i < shared_points.size(); ++i) {
         printf("  %zu: (%.2f, %.2f)\n", i+1, shared_points[i].getX(), shared_points[i].getY());
     }
@@ -102,14 +167,35 @@ void printCurrentGraph() {
 
 int main(int argc, char *argv[])
 {
-    if (argc != 2)
+    // <port> [--calibrate] [--data-dir dir]; Loadgraph only reads point
+    // files under the data directory, and is off without one
+    bool calibrate = false;
+    bool args_ok = argc >= 2;
+    for (int i = 2; i < argc && args_ok; ++i) {
+        if (strcmp(argv[i], "--calibrate") == 0)
+            calibrate = true;
+        else if (strcmp(argv[i], "--data-dir") == 0 && i + 1 < argc)
+            data_dir = argv[++i];
+        else
+            args_ok = false;
+    }
+    if (!args_ok)
     {
-        fprintf(stderr, "Usage: %s <port>\n", argv[0]);
+        fprintf(stderr, "Usage: %s <port> [--calibrate] [--data-dir dir]\n", argv[0]);
         return 1;
     }
 
     signal(SIGINT, handle_sigint);
 
+    // Engine picked per graph from a sample; --calibrate first measures
+    // the crossovers between engines on this host
+    ch.setAlgorithm(ConvexHull::Algorithm::Auto);
+    if (calibrate) {
+        printf("Calibrating hull engines...\n");
+        EngineSelector::calibrate();
+        EngineSelector::printProfiles(std::cout);
+    }
+
     // Initialize graph
     initializeGraph();
     
@@ -164,6 +250,7 @@ int main(int argc, char *argv[])
     printf("  Newpoint x y - Add point to graph\n");
     printf("  Removepoint x y - Remove point from graph\n");
     printf("  CH - Compute convex hull\n");
+    printf("  Loadgraph name - Replace graph with a binary point file from the data directory\n");
 
     while (running)
     {
@@ -200,7 +287,7 @@ int main(int argc, char *argv[])
                 
                 // Send welcome message
                 const char* welcome = "Connected to Convex Hull Server\n"
-                                     "Commands: Newgraph, Newpoint x y, Removepoint x y, CH\n";
+                                     "Commands: Newgraph, Newpoint x y, Removepoint x y, CH, Loadgraph name\n";
                 send(client_fd, welcome, strlen(welcome), 0);
             }
             else if (client_fd >= 0)
@@ -230,6 +317,11 @@ int main(int argc, char *argv[])
                 }
                 else
                 {
+                    // Hull engine scratch comes from the arena and is dropped
+                    // when the request is done. A recomputed CH reply is a heap
+                    // string owned by the HullCache snapshot, so the first CH
+                    // after a change allocates.
+                    ArenaScope scope;
                     buffer[len] = '\0';
                     
                    
@@ -275,9 +367,9 @@ int main(int argc, char *argv[])
                         float x, y;
                         if (sscanf(buffer + 12, "%f %f", &x, &y) == 2)
                         {
-                            size_t old_size = shared_points.size();
+                            size_t old_size = graphSize();
                             removePointFromGraph(x, y);
-                            if (shared_points.size() < old_size)
+                            if (graphSize() < old_size)
                             {
                                 char response[128];
                                 snprintf(response, sizeof(response), "Point (%.2f, %.2f) removed\n", x, y);
@@ -296,9 +388,14 @@ int main(int argc, char *argv[])
                             send(fds[i].fd, error, strlen(error), 0);
                         }
                     }
+                   else if (strncmp(buffer, "Loadgraph ", 10) == 0)
+                   {
+                       std::string response = loadGraph(buffer + 10);
+                       send(fds[i].fd, response.data(), response.size(), 0);
+                   }
                    else if (strcmp(buffer, "CH") == 0)
                    {
-                       if (shared_points.size() < 3)
+                       if (graphSize() < 3)
                        {
                            const char* error = "Need at least 3 points to compute convex hull\n";
                            send(fds[i].fd, error, strlen(error), 0);
@@ -306,32 +403,16 @@ int main(int argc, char *argv[])
                        else
                        {
                            // קרא לפונקציה שכבר קיימת במקום לחזור על הקוד
-                           computeConvexHull();
+                           HullCache::Snapshot hull = computeConvexHull();
                            
-                           // עכשיו תכין את התגובה ללקוח
-                           std::vector<Point> hull_points = ch->getConvexHullPoints();
-                           double area = ch->polygonArea();
-
-                           char response[1024];
-                           int offset = snprintf(response, sizeof(response), 
-                                                 "Convex Hull (%zu points):\n", hull_points.size());
-
-                           for (const auto& p : hull_points)
-                           {
-                               offset += snprintf(response + offset, sizeof(response) - offset,
-                                                  "(%.2f, %.2f)\n", p.getX(), p.getY());
-                           }
-
-                           offset += snprintf(response + offset, sizeof(response) - offset,
-                                              "Area: %.2f\n", area);
-
-                           send(fds[i].fd, response, offset, 0);
+                           // התגובה ללקוח כבר מוכנה בתוך ה-snapshot
+                           send(fds[i].fd, hull->reply.data(), hull->reply.size(), 0);
                        }
                     }
                     else
                     {
                         printf("Unknown command: '%s'\n", buffer);
-                        const char* error = "Unknown command. Available: Newgraph, Newpoint x y, Removepoint x y, CH\n";
+                        const char* error = "Unknown command. Available: Newgraph, Newpoint x y, Removepoint x y, CH, Loadgraph name\n";
                         send(fds[i].fd, error, strlen(error), 0);
                     }
                 }
@@ -384,12 +465,6 @@ int main(int argc, char *argv[])
     printf("Closing listening socket: fd=%d\n", listen_fd);
     close(listen_fd);
     
-    // Clean up memory
-    if (ch != nullptr) {
-        delete ch;
-        ch = nullptr;
-    }
-    
     printf("Server terminated.\n");
     return 0;
 }
\ No newline at end of file
@@ -11,19 +11,29 @@
 #include <vector>
 #include <string>
 #include <mutex>
+#include <memory>
 #include <iostream>
 #include <algorithm>
 #include <cmath>
 #include <set>
 #include <thread>
 #include <chrono>
+#include "../ex3/arena.hpp"
 #include "../ex3/convex_hull.hpp"
+#include "../ex3/engine_selector.hpp"
+#include "../ex3/hull_cache.hpp"
 #include "../ex3/point.hpp"
+#include "../ex3/point_file.hpp"
+#include "../ex3/point_index.hpp"
 
 // ---------------- Shared Graph --------------------
-std::vector<Point> shared_points;
-ConvexHull* ch = nullptr;
+PointIndex shared_points; // the only copy; ch runs over it as a view
+std::unique_ptr<PointFile> loadedPoints; // a Loadgraph file, the graph until it is edited
+ConvexHull ch;
+uint64_t graphVersion = 0;        // bumped by every change to the graph
+HullCache hullCache;
 std::mutex graphMutex;
+std::string dataDir; // --data-dir, where Loadgraph finds point files
 
 // Reactor global
 void* reactorInstance = nullptr;
@@ -35,7 +45,9 @@ std::mutex clientsMutex;
 void initializeGraph();
 void addPointToGraph(float x, float y);
 void removePointFromGraph(float x, float y);
-void computeConvexHull();
+void loadGraph(const char* name, ArenaText& response);
+size_t graphSize();
+HullCache::Snapshot computeConvexHull();
 void clientHandler(int client_fd);
 void acceptHandler(int listen_fd);
 void cleanupAllClients();
@@ -70,26 +82,41 @@ void handle_sigint(int sig) {
         listen_fd = -1;
     }
     
-    // Clean up memory
-    if (ch) {
-        delete ch;
-        ch = nullptr;
-    }
-    
     printf("Server shut down gracefully.\n");
     exit(0);
 }
 
 // ---------------- main ----------------------------
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        fprintf(stderr, "Usage: %s <port>\n", argv[0]);
+    // <port> [--calibrate] [--data-dir dir]; Loadgraph only reads point
+    // files under the data directory, and is off without one
+    bool calibrate = false;
+    bool args_ok = argc >= 2;
+    for (int i = 2; i < argc && args_ok; ++i) {
+        if (strcmp(argv[i], "--calibrate") == 0)
+            calibrate = true;
+        else if (strcmp(argv[i], "--data-dir") == 0 && i + 1 < argc)
+            dataDir = argv[++i];
+        else
+            args_ok = false;
+    }
+    if (!args_ok) {
+        fprintf(stderr, "Usage: %s <port> [--calibrate] [--data-dir dir]\n", argv[0]);
         return 1;
     }
 
     int port = atoi(argv[1]);
     signal(SIGINT, handle_sigint);
 
+    // Engine picked per graph from a sample; --calibrate first measures
+    // the crossovers between engines on this host
+    ch.setAlgorithm(ConvexHull::Algorithm::Auto);
+    if (calibrate) {
+        printf("Calibrating hull engines...\n");
+        EngineSelector::calibrate();
+        EngineSelector::printProfiles(std::cout);
+    }
+
     // Prepare listening socket
     listen_fd = socket(AF_INET, SOCK_STREAM, 0);
     if (listen_fd < 0) { 
@@ -178,11 +205,6 @@ int main(int argc, char* argv[]) {
         listen_fd = -1;
     }
     
-    if (ch) {
-        delete ch;
-        ch = nullptr;
-    }
-    
     return 0;
 }
 
@@ -224,7 +246,7 @@ void acceptHandler(int listen_fd) {
     // Send welcome message
     const char* welcome =
         "Connected to Convex Hull Server\n"
-        "Commands: Newgraph, Newpoint x y, Removepoint x y, CH\n";
+        "Commands: Newgraph, Newpoint x y, Removepoint x y, CH, Loadgraph name\n";
     
     ssize_t sent = send(client_fd, welcome, strlen(welcome), MSG_NOSIGNAL);
     if (sent < 0) {
@@ -304,57 +326,49 @@ void clientHandler(int client_fd) {
         }
     }
 
-    // Process command with graph mutex
-    std::string response;
+    // Process command with graph mutex. The response and any hull scratch
+    // come from the arena and are dropped when the request is done; a
+    // recomputed CH reply is a heap string owned by the HullCache snapshot.
+    ArenaScope scope;
+    ArenaText response;
+    HullCache::Snapshot hull; // CH replies go out straight from the snapshot
     {
         std::lock_guard<std::mutex> lock(graphMutex);
 
         if (strncasecmp(buffer, "Newgraph", 8) == 0) {
             initializeGraph();
-            response = "New graph created\n";
+            response.appendf("New graph created\n");
         }
         else if (strncasecmp(buffer, "Newpoint", 8) == 0) {
             float x, y;
             if (sscanf(buffer + 8, "%f %f", &x, &y) == 2) {
                 addPointToGraph(x, y);
-                char resp[64];
-                snprintf(resp, sizeof(resp), "Added point (%.2f, %.2f)\n", x, y);
-                response = resp;
+                response.appendf("Added point (%.2f, %.2f)\n", x, y);
             } else {
-                response = "Invalid format. Use: Newpoint x y\n";
+                response.appendf("Invalid format. Use: Newpoint x y\n");
             }
         }
         else if (strncasecmp(buffer, "Removepoint", 11) == 0) {
             float x, y;
             if (sscanf(buffer + 11, "%f %f", &x, &y) == 2) {
                 removePointFromGraph(x, y);
-                char resp[64];
-                snprintf(resp, sizeof(resp), "Removed point (%.2f, %.2f)\n", x, y);
-                response = resp;
+                response.appendf("Removed point (%.2f, %.2f)\n", x, y);
             } else {
-                response = "Invalid format. Use: Removepoint x y\n";
+                response.appendf("Invalid format. Use: Removepoint x y\n");
             }
         }
+        else if (strncasecmp(buffer, "Loadgraph ", 10) == 0) {
+            loadGraph(buffer + 10, response);
+        }
         else if (strncasecmp(buffer, "CH", 2) == 0) {
-            if (shared_points.size() < 3) {
-                response = "Need at least 3 points to compute convex hull\n";
+            if (graphSize() < 3) {
+                response.appendf("Need at least 3 points to compute convex hull\n");
             } else {
-                computeConvexHull();
-                std::vector<Point> hull = ch->getConvexHullPoints();
-                double area = ch->polygonArea();
-                
-                char resp[1024];
-                int off = snprintf(resp, sizeof(resp), "Convex Hull (%zu points):\n", hull.size());
-                for (const auto& p : hull) {
-                    off += snprintf(resp + off, sizeof(resp) - off,
-                                   "(%.2f, %.2f)\n", p.getX(), p.getY());
-                }
-                off += snprintf(resp + off, sizeof(resp) - off, "Area: %.2f\n", area);
-                response = resp;
+                hull = computeConvexHull();
             }
         }
         else {
-            response = "Unknown command. Available: Newgraph, Newpoint x y, Removepoint x y, CH\n";
+            response.appendf("Unknown command. Available: Newgraph, Newpoint x y, Removepoint x y, CH, Loadgraph name\n");
         }
     }
 
@@ -368,7 +382,8 @@ void clientHandler(int client_fd) {
     }
 
     // Send response
-    ssize_t sent = send(client_fd, response.c_str(), response.length(), MSG_NOSIGNAL);
+    ssize_t sent = hull ? send(client_fd, hull->reply.data(), hull->reply.size(), MSG_NOSIGNAL)
+                        : send(client_fd, response.data(), response.size(), MSG_NOSIGNAL);
     if (sent < 0) {
         if (errno == EPIPE || errno == ECONNRESET) {
             printf("Client fd=%d disconnected while sending response\n", client_fd);
@@ -397,56 +412,106 @@ void clientHandler(int client_fd) {
 }
 
 // ---------------- Graph Management Functions -------------------
+// A loaded file stays mapped and is hulled where it lies until the first
+// Newpoint or Removepoint, which copies it into the index
+void materializeLoadedGraph() {
+    if (!loadedPoints) return;
+    shared_points.assign(loadedPoints->xData(), loadedPoints->yData(), loadedPoints->size());
+    loadedPoints.reset();
+}
+
+size_t graphSize() {
+    return loadedPoints ? loadedPoints->size() : shared_points.size();
+}
+
 void initializeGraph() {
-    if (ch) {
-        delete ch;
-        ch = nullptr;
-    }
+    loadedPoints.reset();
     shared_points.clear();
-    ch = new ConvexHull(shared_points);
+    ++graphVersion;
     printf("DEBUG: Graph initialized\n");
 }
 
 void addPointToGraph(float x, float y) {
-    // Check if point already exists
-    for (const auto& p : shared_points) {
-        if (std::abs(p.getX() - x) < 0.001f && std::abs(p.getY() - y) < 0.001f) {
-            printf("DEBUG: Point (%.2f, %.2f) already exists, skipping\n", x, y);
-            return;
-        }
+    materializeLoadedGraph();
+    // Check if point already exists: expected O(1) in the cell grid
+    if (shared_points.containsNear(x, y)) {
+        printf("DEBUG: Point (%.2f, %.2f) already exists, skipping\n", x, y);
+        return;
     }
     
-    shared_points.emplace_back(x, y);
-    if (ch) {
-        delete ch;
+    // A point inside the cached hull or on its boundary cannot change it
+    bool inside = hullCache.contains(graphVersion, x, y);
+    shared_points.add(Point(x, y));
+    ++graphVersion;
+    if (inside && hullCache.carry(graphVersion - 1, graphVersion)) {
+        printf("DEBUG: Point is inside the hull, cached hull kept (%llu recomputes avoided)\n",
+               (unsigned long long)hullCache.getAvoidedRecomputes());
     }
-    ch = new ConvexHull(shared_points);
     printf("DEBUG: Added point (%.2f, %.2f), total points: %zu\n", x, y, shared_points.size());
 }
 
 void removePointFromGraph(float x, float y) {
-    auto it = std::remove_if(shared_points.begin(), shared_points.end(),
-        [x, y](const Point& p) { 
-            return std::abs(p.getX() - x) < 0.001f && std::abs(p.getY() - y) < 0.001f; 
-        });
-    
-    if (it != shared_points.end()) {
-        shared_points.erase(it, shared_points.end());
-        if (ch) {
-            delete ch;
+    materializeLoadedGraph();
+    // The hull survives unless one of the removed points is its vertex
+    bool hull_kept = true;
+    size_t removed = shared_points.removeNear(x, y, [&hull_kept](const Point& p) {
+        if (hullCache.isVertex(graphVersion, p.getX(), p.getY()))
+            hull_kept = false;
+    });
+    
+    if (removed > 0) {
+        ++graphVersion;
+        if (hull_kept && hullCache.carry(graphVersion - 1, graphVersion)) {
+            printf("DEBUG: No hull vertex removed, cached hull kept (%llu recomputes avoided)\n",
+                   (unsigned long long)hullCache.getAvoidedRecomputes());
         }
-        ch = new ConvexHull(shared_points);
         printf("DEBUG: Removed point (%.2f, %.2f), remaining points: %zu\n", x, y, shared_points.size());
     } else {
         printf("DEBUG: Point (%.2f, %.2f) not found for removal\n", x, y);
     }
 }
 
-void computeConvexHull() {
-    if (ch && shared_points.size() >= 3) {
-        ch->findConvexHull();
-        printf("DEBUG: Computed convex hull for %zu points\n", shared_points.size());
+// Replaces the graph with the point file (point_file.hpp) of that name
+// under dataDir. The file is mapped, not parsed, and CH hulls its arrays
+// in place; see materializeLoadedGraph().
+void loadGraph(const char* name, ArenaText& response) {
+    std::string path, error;
+    if (!resolvePointFilePath(dataDir, name, path, error)) {
+        response.appendf("Cannot load %s: %s\n", name, error.c_str());
+        return;
+    }
+    std::unique_ptr<PointFile> file(new PointFile);
+    if (!file->open(path.c_str())) {
+        response.appendf("Cannot load %s: %s\n", name, file->error().c_str());
+        return;
     }
+    if (file->size() > PointIndex::maxSize) {
+        response.appendf("Cannot load %s: too many points\n", name);
+        return;
+    }
+    shared_points.clear();
+    loadedPoints = std::move(file);
+    ++graphVersion;
+    const PointFileHeader& h = loadedPoints->header();
+    printf("DEBUG: Loaded %zu points from %s, bounds (%.2f, %.2f) - (%.2f, %.2f)\n", loadedPoints->size(),
+           path.c_str(), h.minX, h.minY, h.maxX, h.maxY);
+    response.appendf("Graph loaded with %zu points\n", loadedPoints->size());
+}
+
+// Called with graphMutex held. Only the first CH after a change recomputes;
+// later ones get the cached snapshot.
+HullCache::Snapshot computeConvexHull() {
+    HullCache::Snapshot hull = hullCache.lookup(graphVersion);
+    if (hull) {
+        printf("DEBUG: Convex hull unchanged since version %llu\n", (unsigned long long)graphVersion);
+        return hull;
+    }
+    if (loadedPoints)
+        ch.findConvexHull(loadedPoints->xData(), loadedPoints->yData(), loadedPoints->size());
+    else
+        ch.findConvexHull(shared_points.data(), shared_points.size());
+    printf("DEBUG: Computed convex hull for %zu points\n", graphSize());
+    return hullCache.store(graphVersion, ch.getConvexHullPoints(), ch.polygonArea());
 }
 
 void cleanupAllClients() {
@@ -8,12 +8,21 @@
 #include <unistd.h>
 #include <algorithm>
 #include <cmath>
+#include <string>
 #include <vector>
 #include <iostream>
 #include <thread>
 #include <mutex>
+#include <memory>
+#include "../ex3/arena.hpp"
+#include "../ex3/batch_hull.hpp"
 #include "../ex3/convex_hull.hpp"
+#include "../ex3/engine_selector.hpp"
+#include "../ex3/hull_cache.hpp"
 #include "../ex3/point.hpp"
+#include "../ex3/point_file.hpp"
+#include "../ex3/point_index.hpp"
+#include "../ex3/socket_io.hpp"
 
 #define BACKLOG 10
 
@@ -24,9 +33,13 @@ void handleClient(int client_fd);
 //------------------- Thread-safe Graph functions ------------------------------------
 
 // Global shared graph and convex hull object - WITH MUTEX PROTECTION
-std::vector<Point> shared_points;
-ConvexHull* ch = nullptr;
+PointIndex shared_points; // the only copy; ch runs over it as a view
+std::unique_ptr<PointFile> loaded_points; // a Loadgraph file, the graph until it is edited
+ConvexHull ch;
+uint64_t graph_version = 0; // bumped by every change to the graph
+HullCache hull_cache;
 std::mutex graph_mutex;
+std::string data_dir; // --data-dir, where Loadgraph finds point files
 
 // Global variable to control server shutdown
 volatile sig_atomic_t running = 1;
@@ -48,76 +61,118 @@ void handle_sigint(int sig)
         listen_fd = -1;
     }
     
-    // Clean up memory
-    if (ch != nullptr) {
-        delete ch;
-        ch = nullptr;
-    }
-    
     printf("Server shut down gracefully.\n");
     exit(0);
 }
 
+// Called with graph_mutex held. A loaded file stays mapped and is hulled
+// where it lies until the first Newpoint or Removepoint, which copies it
+// into the index.
+void materializeLoadedGraph() {
+    if (!loaded_points) return;
+    shared_points.assign(loaded_points->xData(), loaded_points->yData(), loaded_points->size());
+    loaded_points.reset();
+}
+
+// Called with graph_mutex held
+size_t graphSize() {
+    return loaded_points ? loaded_points->size() : shared_points.size();
+}
+
 void initializeGraph() {
     std::lock_guard<std::mutex> lock(graph_mutex);
-    if (ch != nullptr) {
-        delete ch;
-    }
+    loaded_points.reset();
     shared_points.clear();
-    ch = new ConvexHull(shared_points);
+    ++graph_version;
     printf("New graph initialized\n");
 }
 
 void addPointToGraph(float x, float y) {
     std::lock_guard<std::mutex> lock(graph_mutex);
+    materializeLoadedGraph();
     
-    // Check if point already exists
-    for (const auto& p : shared_points) {
-        if (std::abs(p.getX() - x) < 0.001f && std::abs(p.getY() - y) < 0.001f) {
-            printf("Point (%.2f, %.2f) already exists, skipping\n", x, y);
-            return;
-        }
+    // Check if point already exists: expected O(1) in the cell grid
+    if (shared_points.containsNear(x, y)) {
+        printf("Point (%.2f, %.2f) already exists, skipping\n", x, y);
+        return;
     }
     
-    shared_points.emplace_back(x, y);
-    if (ch != nullptr) {
-        delete ch;
+    // A point inside the cached hull or on its boundary cannot change it
+    bool inside = hull_cache.contains(graph_version, x, y);
+    shared_points.add(Point(x, y));
+    ++graph_version;
+    if (inside && hull_cache.carry(graph_version - 1, graph_version)) {
+        printf("Point is inside the hull, cached hull kept (%llu recomputes avoided)\n",
+               (unsigned long long)hull_cache.getAvoidedRecomputes());
     }
-    ch = new ConvexHull(shared_points);
     printf("Added point (%.2f, %.2f). Total points: %zu\n", x, y, shared_points.size());
 }
 
 void removePointFromGraph(float x, float y) {
     std::lock_guard<std::mutex> lock(graph_mutex);
-    Point targetPoint(x, y);
-    auto it = std::remove_if(shared_points.begin(), shared_points.end(),
-        [&targetPoint](const Point& p) {
-            return std::abs(p.getX() - targetPoint.getX()) < 0.001f && 
-                   std::abs(p.getY() - targetPoint.getY()) < 0.001f;
-        });
+    materializeLoadedGraph();
+    // The hull survives unless one of the removed points is its vertex
+    bool hull_kept = true;
+    size_t removed = shared_points.removeNear(x, y, [&hull_kept](const Point& p) {
+        if (hull_cache.isVertex(graph_version, p.getX(), p.getY()))
+            hull_kept = false;
+    });
     
-    if (it != shared_points.end()) {
-        shared_points.erase(it, shared_points.end());
-        if (ch != nullptr) {
-            delete ch;
+    if (removed > 0) {
+        ++graph_version;
+        if (hull_kept && hull_cache.carry(graph_version - 1, graph_version)) {
+            printf("No hull vertex removed, cached hull kept (%llu recomputes avoided)\n",
+                   (unsigned long long)hull_cache.getAvoidedRecomputes());
         }
-        ch = new ConvexHull(shared_points);
         printf("Removed point (%.2f, %.2f). Total points: %zu\n", x, y, shared_points.size());
     } else {
         printf("Point (%.2f, %.2f) not found\n", x, y);
     }
 }
 
-std::pair<std::vector<Point>, double> computeConvexHullSafe() {
+// Loadgraph name: replaces the graph with the point file (point_file.hpp)
+// of that name under data_dir. The file is mapped, not parsed, and CH
+// hulls its arrays in place; see materializeLoadedGraph().
+std::string loadGraph(const char* name) {
+    std::string path, error;
+    if (!resolvePointFilePath(data_dir, name, path, error))
+        return std::string("Cannot load ") + name + ": " + error + "\n";
+    std::unique_ptr<PointFile> file(new PointFile);
+    if (!file->open(path.c_str()))
+        return std::string("Cannot load ") + name + ": " + file->error() + "\n";
+    if (file->size() > PointIndex::maxSize)
+        return std::string("Cannot load ") + name + ": too many points\n";
+
+    std::lock_guard<std::mutex> lock(graph_mutex);
+    shared_points.clear();
+    loaded_points = std::move(file);
+    ++graph_version;
+    const PointFileHeader& h = loaded_points->header();
+    printf("Loaded %zu points from %s, bounds (%.2f, %.2f) - (%.2f, %.2f)\n", loaded_points->size(),
+           path.c_str(), h.minX, h.minY, h.maxX, h.maxY);
+    return "Graph loaded with " + std::to_string(loaded_points->size()) + " points\n";
+}
+
+// Hull, area and reply of the current graph. Only the first CH after a
+// change recomputes; the snapshot stays valid after the lock is released.
+HullCache::Snapshot computeConvexHullSafe() {
     std::lock_guard<std::mutex> lock(graph_mutex);
     
+    HullCache::Snapshot cached = hull_cache.lookup(graph_version);
+    if (cached) {
+        return cached;
+    }
+    
     std::vector<Point> hull_points;
     double area = 0.0;
     
-    if (shared_points.size() >= 3 && ch != nullptr) {
-        ch->findConvexHull();
-        hull_points = ch->getConvexHullPoints();
-        area = ch->polygonArea();
+    if (graphSize() >= 3) {
+        if (loaded_points)
+            ch.findConvexHull(loaded_points->xData(), loaded_points->yData(), loaded_points->size());
+        else
+            ch.findConvexHull(shared_points.data(), shared_points.size());
+        hull_points = ch.getConvexHullPoints();
+        area = ch.polygonArea();
         
         printf("Computed convex hull with %zu points, area: %.2f\n", hull_points.size(), area);
         for (const auto& p : hull_points) {
@@ -125,12 +180,19 @@ std::pair<std::vector<Point>, double> computeConvexHullSafe() {
         }
     }
     
-    return {hull_points, area};
+    return hull_cache.store(graph_version, hull_points, area);
 }
 
 void printCurrentGraph() {
     std::lock_guard<std::mutex> lock(graph_mutex);
-    printf("Current graph has %zu points:\n", shared_points.size());
+    printf("Current graph has %zu points:\n", graphSize());
+    if (loaded_points) {
+        const float* xs = loaded_points->xData();
+        const float* ys = loaded_points->yData();
+        for (size_t i = 0; i < loaded_points->size(); ++i)
+            printf("  %zu: (%.2f, %.2f)\n", i+1, xs[i], ys[i]);
+        return;
+    }
     for (size_t i = 0; i < shared_points.size(); ++i) {
         printf("  %zu: (%.2f, %.2f)\n", i+1, shared_points[i].getX(), shared_points[i].getY());
     }
@@ -138,9 +200,14 @@ void printCurrentGraph() {
 
 size_t getPointCount() {
     std::lock_guard<std::mutex> lock(graph_mutex);
-    return shared_points.size();
+    return graphSize();
 }
 
+//------------------- Bulk hulls -------------------------------------------
+
+// Independent of the shared graph, so bulk requests take no lock
+BatchHull batch_hull;
+
 //------------------------------------------------------------------------
 
 void handleClient(int client_fd) {
@@ -148,15 +215,17 @@ void handleClient(int client_fd) {
     
     // Send welcome message
     const char* welcome = "Connected to Convex Hull Server\n"
-                         "Commands: Newgraph, Newpoint x y, Removepoint x y, CH\n";
+                         "Commands: Newgraph, Newpoint x y, Removepoint x y, CH, Loadgraph name, Bulk sets points\n";
     send(client_fd, welcome, strlen(welcome), 0);
     
+    // Bytes received but not handled yet, from which commands are taken a
+    // line at a time: a Bulk request may span several reads, and what
+    // follows a command or a Bulk payload starts the next one
+    std::string pending, line;
     while (running) {
-        char buffer[256];
-        ssize_t len = read(client_fd, buffer, sizeof(buffer) - 1);
-
-        if (len <= 0) {
-            if (len == 0) {
+        int got = readLine(client_fd, pending, line);
+        if (got <= 0) {
+            if (got == 0) {
                 printf("[Thread %lu] Client disconnected gracefully: fd=%d\n", std::hash<std::thread::id>{}(std::this_thread::get_id()), client_fd);
             } else {
                 printf("[Thread %lu] Client connection error: fd=%d (%s)\n", std::hash<std::thread::id>{}(std::this_thread::get_id()), client_fd, strerror(errno));
@@ -164,18 +233,28 @@ void handleClient(int client_fd) {
             break;
         }
 
-        buffer[len] = '\0';
+        // Hull engine scratch comes from the arena and is dropped when the
+        // request is done. A recomputed CH reply is a heap string owned by
+        // the HullCache snapshot, so the first CH after a change allocates.
+        ArenaScope scope;
+
+        // Bulk is followed by a binary payload, so it is taken before the cleanup below
+        if (line.compare(0, 5, "Bulk ") == 0) {
+            printf("[Thread %lu] Received command: '%s'\n", std::hash<std::thread::id>{}(std::this_thread::get_id()), line.c_str());
+            if (!serveBulk(client_fd, line, pending, batch_hull))
+                break;
+            continue;
+        }
         
         // Clean non-printable characters
-        char cleaned[256];
-        int j = 0;
-        for (int k = 0; k < len && j < 255; k++) {
-            if (buffer[k] >= 32 && buffer[k] <= 126) {
-                cleaned[j++] = buffer[k];
+        char buffer[maxCommandLine + 1];
+        size_t j = 0;
+        for (size_t k = 0; k < line.size() && j < maxCommandLine; k++) {
+            if (line[k] >= 32 && line[k] <= 126) {
+                buffer[j++] = line[k];
             }
         }
-        cleaned[j] = '\0';
-        strcpy(buffer, cleaned);
+        buffer[j] = '\0';
         
         printf("[Thread %lu] Received command: '%s'\n", std::hash<std::thread::id>{}(std::this_thread::get_id()), buffer);
 
@@ -216,31 +295,23 @@ void handleClient(int client_fd) {
                 send(client_fd, error, strlen(error), 0);
             }
         }
+        else if (strncmp(buffer, "Loadgraph ", 10) == 0) {
+            std::string response = loadGraph(buffer + 10);
+            send(client_fd, response.data(), response.size(), 0);
+        }
         else if (strcmp(buffer, "CH") == 0) {
-            auto [hull_points, area] = computeConvexHullSafe();
+            HullCache::Snapshot hull = computeConvexHullSafe();
             
-            if (hull_points.empty()) {
+            if (hull->hull.empty()) {
                 const char* error = "Need at least 3 points to compute convex hull\n";
                 send(client_fd, error, strlen(error), 0);
             } else {
-                char response[1024];
-                int offset = snprintf(response, sizeof(response), 
-                                     "Convex Hull (%zu points):\n", hull_points.size());
-
-                for (const auto& p : hull_points) {
-                    offset += snprintf(response + offset, sizeof(response) - offset,
-                                      "(%.2f, %.2f)\n", p.getX(), p.getY());
-                }
-
-                offset += snprintf(response + offset, sizeof(response) - offset,
-                                  "Area: %.2f\n", area);
-
-                send(client_fd, response, offset, 0);
+                send(client_fd, hull->reply.data(), hull->reply.size(), 0);
             }
         }
         else {
             printf("[Thread %lu] Unknown command: '%s'\n", std::hash<std::thread::id>{}(std::this_thread::get_id()), buffer);
-            const char* error = "Unknown command. Available: Newgraph, Newpoint x y, Removepoint x y, CH\n";
+            const char* error = "Unknown command. Available: Newgraph, Newpoint x y, Removepoint x y, CH, Loadgraph name, Bulk sets points\n";
             send(client_fd, error, strlen(error), 0);
         }
     }
@@ -293,13 +364,34 @@ void acceptClients(int listen_fd) {
 
 int main(int argc, char *argv[])
 {
-    if (argc != 2) {
-        fprintf(stderr, "Usage: %s <port>\n", argv[0]);
+    // <port> [--calibrate] [--data-dir dir]; Loadgraph only reads point
+    // files under the data directory, and is off without one
+    bool calibrate = false;
+    bool args_ok = argc >= 2;
+    for (int i = 2; i < argc && args_ok; ++i) {
+        if (strcmp(argv[i], "--calibrate") == 0)
+            calibrate = true;
+        else if (strcmp(argv[i], "--data-dir") == 0 && i + 1 < argc)
+            data_dir = argv[++i];
+        else
+            args_ok = false;
+    }
+    if (!args_ok) {
+        fprintf(stderr, "Usage: %s <port> [--calibrate] [--data-dir dir]\n", argv[0]);
         return 1;
     }
 
     signal(SIGINT, handle_sigint);
 
+    // Engine picked per graph from a sample; --calibrate first measures
+    // the crossovers between engines on this host
+    ch.setAlgorithm(ConvexHull::Algorithm::Auto);
+    if (calibrate) {
+        printf("Calibrating hull engines...\n");
+        EngineSelector::calibrate();
+        EngineSelector::printProfiles(std::cout);
+    }
+
     // Initialize graph
     initializeGraph();
     
@@ -342,6 +434,8 @@ int main(int argc, char *argv[])
     printf("  Newpoint x y - Add point to graph\n");
     printf("  Removepoint x y - Remove point from graph\n");
     printf("  CH - Compute convex hull\n");
+    printf("  Loadgraph name - Replace graph with a binary point file from the data directory\n");
+    printf("  Bulk sets points - Hulls of many point sets sent as binary CSR\n");
 
     // Store listen_fd globally for signal handler
     ::listen_fd = listen_fd;
@@ -394,11 +488,6 @@ int main(int argc, char *argv[])
         close(listen_fd);
     }
     
-    if (ch != nullptr) {
-        delete ch;
-        ch = nullptr;
-    }
-    
     printf("Server terminated.\n");
     return 0;
 }
\ No newline at end of file